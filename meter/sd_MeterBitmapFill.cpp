@@ -0,0 +1,129 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterBitmapFill.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+namespace BitmapFill
+{
+void blendRow (juce::PixelARGB* pixels, int numPixels, juce::PixelARGB colour, bool useSimd /*= true*/) noexcept
+{
+    if (pixels == nullptr || numPixels <= 0 || colour.getAlpha() == 0)
+        return;
+
+    auto* row      = reinterpret_cast<uint32_t*> (pixels);  // NOLINT
+    int   pixelIdx = 0;
+
+    if (colour.getAlpha() == 0xff)
+    {
+        // Opaque: the blend is just a store...
+        std::fill (row, row + numPixels, colour.getNativeARGB());
+        return;
+    }
+
+    // The same arithmetic as PixelARGB::blend, on the even (red, blue) and odd (alpha, green) bytes in 16 bit lanes:
+    // dest = min (src + ((dest * (256 - srcAlpha)) >> 8), 255).
+    const auto source      = colour.getNativeARGB();
+    const auto sourceEven  = static_cast<uint16_t> (source & 0xff);
+    const auto sourceEven2 = static_cast<uint16_t> ((source >> 16) & 0xff);
+    const auto sourceOdd   = static_cast<uint16_t> ((source >> 8) & 0xff);
+    const auto sourceOdd2  = static_cast<uint16_t> (source >> 24);
+    const auto inverse     = static_cast<uint16_t> (0x100 - colour.getAlpha());
+
+    if (useSimd)
+    {
+#if JUCE_USE_SSE_INTRINSICS
+        // Lane 0 holds the even (or odd) bytes of the low half of a pixel, lane 1 those of the high half...
+        const auto evenSrc = _mm_set_epi16 (static_cast<short> (sourceEven2), static_cast<short> (sourceEven), static_cast<short> (sourceEven2), static_cast<short> (sourceEven),
+                                            static_cast<short> (sourceEven2), static_cast<short> (sourceEven), static_cast<short> (sourceEven2), static_cast<short> (sourceEven));
+        const auto oddSrc  = _mm_set_epi16 (static_cast<short> (sourceOdd2), static_cast<short> (sourceOdd), static_cast<short> (sourceOdd2), static_cast<short> (sourceOdd),
+                                            static_cast<short> (sourceOdd2), static_cast<short> (sourceOdd), static_cast<short> (sourceOdd2), static_cast<short> (sourceOdd));
+        const auto alpha   = _mm_set1_epi16 (static_cast<short> (inverse));
+        const auto byteMax = _mm_set1_epi16 (0xff);
+
+        for (; pixelIdx + 4 <= numPixels; pixelIdx += 4)
+        {
+            auto*      dest       = reinterpret_cast<__m128i*> (row + pixelIdx);  // NOLINT
+            const auto destPixels = _mm_loadu_si128 (dest);
+            const auto destEven   = _mm_srli_epi16 (_mm_mullo_epi16 (_mm_and_si128 (destPixels, byteMax), alpha), 8);
+            const auto destOdd    = _mm_srli_epi16 (_mm_mullo_epi16 (_mm_srli_epi16 (destPixels, 8), alpha), 8);
+            const auto blendEven  = _mm_min_epi16 (_mm_add_epi16 (destEven, evenSrc), byteMax);
+            const auto blendOdd   = _mm_min_epi16 (_mm_add_epi16 (destOdd, oddSrc), byteMax);
+            _mm_storeu_si128 (dest, _mm_or_si128 (blendEven, _mm_slli_epi16 (blendOdd, 8)));
+        }
+#elif JUCE_USE_ARM_NEON
+        const uint16_t evenLanes[8] = { sourceEven, sourceEven2, sourceEven, sourceEven2, sourceEven, sourceEven2, sourceEven, sourceEven2 };
+        const uint16_t oddLanes[8]  = { sourceOdd, sourceOdd2, sourceOdd, sourceOdd2, sourceOdd, sourceOdd2, sourceOdd, sourceOdd2 };
+        const auto     evenSrc      = vld1q_u16 (evenLanes);
+        const auto     oddSrc       = vld1q_u16 (oddLanes);
+        const auto     alpha        = vdupq_n_u16 (inverse);
+        const auto     byteMax      = vdupq_n_u16 (0xff);
+
+        for (; pixelIdx + 4 <= numPixels; pixelIdx += 4)
+        {
+            const auto destPixels = vreinterpretq_u16_u32 (vld1q_u32 (row + pixelIdx));
+            const auto destEven   = vshrq_n_u16 (vmulq_u16 (vandq_u16 (destPixels, byteMax), alpha), 8);
+            const auto destOdd    = vshrq_n_u16 (vmulq_u16 (vshrq_n_u16 (destPixels, 8), alpha), 8);
+            const auto blendEven  = vminq_u16 (vaddq_u16 (destEven, evenSrc), byteMax);
+            const auto blendOdd   = vminq_u16 (vaddq_u16 (destOdd, oddSrc), byteMax);
+            vst1q_u32 (row + pixelIdx, vreinterpretq_u32_u16 (vorrq_u16 (blendEven, vshlq_n_u16 (blendOdd, 8))));
+        }
+#endif
+    }
+
+    for (; pixelIdx < numPixels; ++pixelIdx)
+        pixels[pixelIdx].blend (colour);
+}
+//==============================================================================
+
+void fillRows (juce::Image::BitmapData& bitmap, juce::Rectangle<int> area, const juce::PixelARGB* colourColumn, bool useSimd /*= true*/) noexcept
+{
+    jassert (bitmap.pixelFormat == juce::Image::ARGB);  // NOLINT
+
+    const auto fillArea = area.getIntersection ({ bitmap.width, bitmap.height });
+    if (fillArea.isEmpty() || colourColumn == nullptr || bitmap.pixelFormat != juce::Image::ARGB)
+        return;
+
+    for (int y = fillArea.getY(); y < fillArea.getBottom(); ++y)
+    {
+        auto* pixels = reinterpret_cast<juce::PixelARGB*> (bitmap.getPixelPointer (fillArea.getX(), y));  // NOLINT
+        blendRow (pixels, fillArea.getWidth(), colourColumn[y - area.getY()], useSimd);
+    }
+}
+//==============================================================================
+
+}  // namespace BitmapFill
+}  // namespace SoundMeter
+}  // namespace sd
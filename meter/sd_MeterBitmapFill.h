@@ -0,0 +1,86 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_graphics/juce_graphics.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief A software bitmap to draw the meter bars into directly, bypassing juce::Graphics.
+ *
+ * @see Rasterizer
+*/
+struct BitmapTarget
+{
+    juce::Image::BitmapData* bitmap  = nullptr;  ///< The pixels to draw into (ARGB).
+    juce::Point<int>         origin  {};         ///< Position of the meter's top left corner in the bitmap (in physical pixels).
+    juce::Rectangle<int>     clip    {};         ///< The part of the bitmap that may be drawn into (in physical pixels).
+    float                    scale   = 1.0f;     ///< Physical pixels per logical pixel.
+    bool                     useSimd = true;     ///< Fill rows with SIMD stores. Otherwise rows are filled pixel by pixel (the pixel exact reference).
+};
+
+/**
+ * @brief Direct pixel fills for axis-aligned meter bars.
+ *
+ * A bar is a rectangle in which every row has a single colour (taken from a colour column),
+ * so every row is blended in one go. The SIMD fills use exactly the same integer arithmetic as juce::PixelARGB::blend,
+ * so their output is identical to the scalar fills (and to juce's software renderer).
+*/
+namespace BitmapFill
+{
+/**
+ * @brief Blend a colour over a row of pixels.
+ *
+ * @param[in,out] pixels    The pixels to blend the colour over.
+ * @param         numPixels The number of pixels in the row.
+ * @param         colour    The (premultiplied) colour to blend.
+ * @param         useSimd   When false, the row is blended pixel by pixel with juce::PixelARGB::blend.
+*/
+void blendRow (juce::PixelARGB* pixels, int numPixels, juce::PixelARGB colour, bool useSimd = true) noexcept;
+
+/**
+ * @brief Fill a rectangle of an ARGB bitmap, every row with it's own colour.
+ *
+ * @param[in,out] bitmap       The bitmap to fill (must be ARGB).
+ * @param         area         The area to fill (in pixels). Clipped to the bitmap.
+ * @param         colourColumn The colour of every row of the area, starting at the top of the area.
+ * @param         useSimd      When false, the rows are blended pixel by pixel with juce::PixelARGB::blend.
+*/
+void fillRows (juce::Image::BitmapData& bitmap, juce::Rectangle<int> area, const juce::PixelARGB* colourColumn, bool useSimd = true) noexcept;
+}  // namespace BitmapFill
+}  // namespace SoundMeter
+}  // namespace sd
@@ -47,6 +47,7 @@ MeterChannel::MeterChannel (const Options& meterOptions, Padding padding, const
 {
     setName (channelName);
     setBufferedToImage (true);
+    setOpaque (true);  // The meter fills it's own background, so nothing behind it needs repainting.
 
     setOptions (meterOptions);
     setIsLabelStrip (isLabelStrip);
@@ -92,27 +93,19 @@ void MeterChannel::paint (juce::Graphics& g)
 }
 //==============================================================================
 
-void MeterChannel::drawMeter (juce::Graphics& g)
+void MeterChannel::drawMeter (juce::Graphics& g, const BitmapTarget* target /*= nullptr*/) const
 {
     // Draw meter BACKGROUND...
-
     g.setColour (m_active ? m_meterColours.backgroundColour : m_meterColours.inactiveColour);
-    
-    m_level.drawMeter (g, m_meterColours);
-}
-//==============================================================================
+    g.fillAll();
 
-bool MeterChannel::isDirty (const juce::Rectangle<int>& rectToCheck /*= {}*/) const noexcept
-{
-    if (rectToCheck.isEmpty())
-        return !m_dirtyRect.isEmpty();
-    return m_dirtyRect.intersects (rectToCheck);
+    m_level.drawMeter (g, m_meterColours, target);
 }
 //==============================================================================
 
 void MeterChannel::addDirty (const juce::Rectangle<int>& dirtyRect) noexcept
 {
-    if (!isShowing())
+    if (!isVisible())  // Not isShowing, since meters drawn by the panel are no child components.
         return;
     m_dirtyRect = m_dirtyRect.getUnion (dirtyRect);
 }
@@ -120,7 +113,7 @@ void MeterChannel::addDirty (const juce::Rectangle<int>& dirtyRect) noexcept
 
 void MeterChannel::setDirty (bool isDirty /*= true*/) noexcept
 {
-    if (!isShowing())
+    if (!isVisible())
         return;
     m_dirtyRect = { 0, 0, 0, 0 };
     if (isDirty)
@@ -133,22 +126,11 @@ void MeterChannel::refresh (const bool forceRefresh)
     if (!isShowing())
         return;
 
-    if (getBounds().isEmpty())
-        return;
-
-    if (m_active)
-    {
-        m_level.refreshMeterLevel();
-        const auto levelDirtyBounds = m_level.getDirtyBounds();
-        if (!levelDirtyBounds.isEmpty())
-            addDirty (levelDirtyBounds);
-    }
-
     // Redraw if dirty or forced to...
-    if (isDirty())
+    const auto dirtyBounds = refreshLevel();
+    if (!dirtyBounds.isEmpty())
     {
-        repaint (m_dirtyRect);
-        setDirty (false);
+        repaint (dirtyBounds);
     }
     else if (forceRefresh)
     {
@@ -157,6 +139,19 @@ void MeterChannel::refresh (const bool forceRefresh)
 }
 //==============================================================================
 
+juce::Rectangle<int> MeterChannel::refreshLevel()
+{
+    // Take the parts marked dirty by the meter itself (mouse over, reset, new segments)...
+    const auto dirtyRect = std::exchange (m_dirtyRect, {});
+
+    if (getBounds().isEmpty() || !m_active)
+        return dirtyRect;
+
+    m_level.refreshMeterLevel();
+    return dirtyRect.getUnion (m_level.getDirtyBounds());
+}
+//==============================================================================
+
 void MeterChannel::setActive (bool isActive, NotificationOptions notify /*= NotificationOptions::dontNotify*/)
 {
     if (m_active == isActive)
@@ -36,7 +36,6 @@
 #include "sd_MeterLevel.h"
 
 #include <juce_audio_basics/juce_audio_basics.h>
-#include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_core/juce_core.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 
@@ -100,6 +99,28 @@ public:
     */
     void setRefreshRate (float refreshRate_hz) { m_level.setRefreshRate (refreshRate_hz); }
 
+    /**
+     * @brief Refresh the meter level, without repainting.
+     *
+     * Used when the meters panel repaints the meter itself (see RenderMode::singleComponent and MetersComponent::setMaxRepaintRegions).
+     * The parts of the meter marked dirty since the last refresh (mouse over, reset, new segments) are included, and cleared.
+     *
+     * @return The part of the meter (in the meter's coordinates) that needs a repaint.
+     * @see refresh, drawMeter
+    */
+    [[nodiscard]] juce::Rectangle<int> refreshLevel();
+
+    /**
+     * @brief Draw the meter, with it's top left corner at the origin of the graphics context.
+     *
+     * Drawing is a pure function of the levels at the last refresh.
+     *
+     * @param[in,out] g      The juce graphics context to use.
+     * @param         target When not a nullptr, the bars are written straight into this bitmap (see Rasterizer).
+     * @see refreshLevel
+    */
+    void drawMeter (juce::Graphics& g, const BitmapTarget* target = nullptr) const;
+
     /**
      * @brief Set meter decay.
      *
@@ -132,8 +153,65 @@ public:
      * Called from the audio thread!
      *
      * @param inputLevel New input level (in amp).
+     * @param producer   The index of the producer (thread) setting the level.
+     *
+     * @see setNumProducers
+    */
+    inline void setInputLevel (float inputLevel, int producer = 0) noexcept { m_level.setInputLevel (inputLevel, producer); }
+
+    /**
+     * @brief Set the number of producers (threads) feeding this meter.
+     *
+     * Beware: never call this while the audio engine is setting levels!
+     *
+     * @param numProducers The number of producers.
+     *
+     * @see setInputLevel
+    */
+    void setNumProducers (int numProducers) { m_level.setNumProducers (numProducers); }
+
+    /**
+     * @brief Set the level of a block of audio, calculating the ballistics on the audio thread.
+     *
+     * Used with sample accurate ballistics (see Options::sampleAccurateBallistics).
+     * Called from the audio thread!
+     *
+     * @param blockPeak  The peak level of the block (in amp).
+     * @param numSamples The number of samples in the block.
+     *
+     * @see setSampleRate
+    */
+    inline void setInputBlockLevel (float blockPeak, int numSamples) noexcept { m_level.setInputBlockLevel (blockPeak, numSamples); }
+
+    /**
+     * @brief Set the sample rate of the audio feeding the meter.
+     *
+     * @param sampleRate The sample rate (in Hz).
+     *
+     * @see setInputBlockLevel
+    */
+    void setSampleRate (double sampleRate) noexcept { m_level.setSampleRate (sampleRate); }
+
+    /**
+     * @brief Set the clock used to time the ballistics and the peak hold.
+     *
+     * The clock is not owned by the meter and should outlive it.
+     * Only used by a standalone meter. A shared bank (see setMeterBank) is timed by the clock set by it's owner.
+     *
+     * @param clock The clock to use, or nullptr to use the default (high resolution, real-time) clock.
+    */
+    void setClock (const Clock* clock) noexcept { m_level.setClock (clock); }
+
+    /**
+     * @brief Display a channel of a shared bank, instead of the meter's own levels.
+     *
+     * The bank is not owned by the meter and should outlive it.
+     * The owner of the bank is responsible for configuring and refreshing it.
+     *
+     * @param bank    The bank to use, or nullptr to use the meter's own levels.
+     * @param channel The channel of the bank to display.
     */
-    inline void setInputLevel (float inputLevel) { m_level.setInputLevel (inputLevel); }
+    void setMeterBank (MeterBank* bank, int channel) { m_level.setMeterBank (bank, channel); }
 
     /**
      * @brief Set the meter's options.
@@ -248,9 +326,7 @@ private:
     MeterColours                m_meterColours      {};
 
     void                        setDirty            (bool isDirty = true) noexcept;
-    [[nodiscard]] bool          isDirty             (const juce::Rectangle<int>& rectToCheck = {}) const noexcept;
     void                        addDirty            (const juce::Rectangle<int>& dirtyRect) noexcept;
-    void                        drawMeter           (juce::Graphics& g);
     void                        mouseMove           (const juce::MouseEvent& event) override;
     void                        mouseExit           (const juce::MouseEvent& event) override;
     void                        mouseDoubleClick    (const juce::MouseEvent& event) override;
@@ -0,0 +1,166 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterGlyphAtlas.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+void GlyphAtlas::prepare (const juce::Font& font, float scale)
+{
+    if (isPreparedFor (font, scale))
+        return;
+
+    m_font  = font;
+    m_scale = scale;
+
+    static constexpr std::array<const char*, numGlyphs> kGlyphTexts { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "-", ".", "-inf" };
+
+    // Size the cells in whole physical pixels, with all digits as wide as the widest one...
+    std::array<float, numGlyphs> textWidths {};
+    for (size_t glyph = 0; glyph < textWidths.size(); ++glyph)
+        textWidths[glyph] = font.getStringWidthFloat (kGlyphTexts[glyph]);
+    const auto digitWidth = *std::max_element (textWidths.begin(), textWidths.begin() + minusGlyph);
+    std::fill (textWidths.begin(), textWidths.begin() + minusGlyph, digitWidth);
+
+    std::array<int, numGlyphs> cellWidths {};
+    for (size_t glyph = 0; glyph < cellWidths.size(); ++glyph)
+    {
+        cellWidths[glyph]    = std::max (1, static_cast<int> (std::ceil (textWidths[glyph] * scale)));
+        m_glyphWidths[glyph] = static_cast<float> (cellWidths[glyph]) / scale;
+    }
+    const auto cellHeight = std::max (1, static_cast<int> (std::ceil (font.getHeight() * scale)));
+
+    // ... and render all glyphs once.
+    m_image = juce::Image (juce::Image::SingleChannel, std::accumulate (cellWidths.begin(), cellWidths.end(), 0), cellHeight, true);
+
+    juce::Graphics imageGraphics (m_image);
+    imageGraphics.addTransform (juce::AffineTransform::scale (scale));
+    imageGraphics.setFont (font);
+    imageGraphics.setColour (juce::Colours::white);
+
+    int cellX = 0;
+    for (size_t glyph = 0; glyph < cellWidths.size(); ++glyph)
+    {
+        const auto cellBounds = juce::Rectangle<int> (cellX, 0, cellWidths[glyph], cellHeight);
+        imageGraphics.drawText (kGlyphTexts[glyph], cellBounds.toFloat() / scale, juce::Justification::centred, false);
+        m_glyphImages[glyph] = m_image.getClippedImage (cellBounds);
+        cellX += cellWidths[glyph];
+    }
+}
+//==============================================================================
+
+bool GlyphAtlas::isPreparedFor (const juce::Font& font, float scale) const noexcept
+{
+    return m_image.isValid() && font == m_font && juce::exactlyEqual (scale, m_scale);
+}
+//==============================================================================
+
+void GlyphAtlas::drawValue (juce::Graphics& g, float value, int numDecimalPlaces, juce::Rectangle<int> bounds, float minusInfinity_db) const
+{
+    if (!m_image.isValid())
+        return;
+
+    std::array<int, 24> glyphs {};
+    size_t              numValueGlyphs = 0;
+    if (value <= minusInfinity_db)
+    {
+        glyphs[numValueGlyphs++] = minusInfinityGlyph;
+    }
+    else
+    {
+        std::array<char, 32> text {};
+        const auto           length = std::snprintf (text.data(), text.size(), "%.*f", numDecimalPlaces, static_cast<double> (value));
+        for (int charIdx = 0; charIdx < length && numValueGlyphs < glyphs.size(); ++charIdx)
+        {
+            const auto glyph = getGlyph (text[static_cast<size_t> (charIdx)]);
+            if (glyph >= 0)
+                glyphs[numValueGlyphs++] = glyph;
+        }
+    }
+
+    auto width = 0.0f;
+    for (size_t glyphIdx = 0; glyphIdx < numValueGlyphs; ++glyphIdx)
+        width += m_glyphWidths[static_cast<size_t> (glyphs[glyphIdx])];
+    const auto height = static_cast<float> (m_image.getHeight()) / m_scale;
+
+    // Start on a physical pixel, so every cell is a plain blit...
+    auto       snap = [this] (float position) { return std::round (position * m_scale) / m_scale; };
+    auto       x    = snap (bounds.toFloat().getCentreX() - width / 2.0f);
+    const auto y    = snap (bounds.toFloat().getCentreY() - height / 2.0f);
+
+    // Clip a value wider (or taller) than the area, so it never draws over the rest of the meter...
+    const juce::Graphics::ScopedSaveState saveState (g);
+    g.reduceClipRegion (bounds);
+
+    for (size_t glyphIdx = 0; glyphIdx < numValueGlyphs; ++glyphIdx)
+    {
+        const auto glyph = static_cast<size_t> (glyphs[glyphIdx]);
+        g.drawImageTransformed (m_glyphImages[glyph], juce::AffineTransform::scale (1.0f / m_scale).translated (x, y), true);
+        x += m_glyphWidths[glyph];
+    }
+}
+//==============================================================================
+
+int GlyphAtlas::getGlyph (char character) noexcept
+{
+    if (character >= '0' && character <= '9')
+        return character - '0';
+    if (character == '-')
+        return minusGlyph;
+    if (character == '.' || character == ',')
+        return pointGlyph;
+    return -1;
+}
+//==============================================================================
+
+const GlyphAtlas& GlyphAtlasCache::getAtlas (const juce::Font& font, float scale)
+{
+    auto atlas = std::find_if (m_atlases.begin(), m_atlases.end(), [&] (const auto& cached) { return cached->isPreparedFor (font, scale); });
+    if (atlas != m_atlases.end())
+    {
+        std::rotate (m_atlases.begin(), atlas, atlas + 1);  // Move it to the front, where it's found first next time.
+        return *m_atlases.front();
+    }
+
+    if (m_atlases.size() >= kMaxNumAtlases)
+        m_atlases.pop_back();  // Drop the least recently used.
+
+    m_atlases.insert (m_atlases.begin(), std::make_unique<GlyphAtlas>());
+    m_atlases.front()->prepare (font, scale);
+    return *m_atlases.front();
+}
+//==============================================================================
+
+}  // namespace SoundMeter
+}  // namespace sd
@@ -0,0 +1,134 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_graphics/juce_graphics.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief Pre-rendered glyphs for numeric readouts.
+ *
+ * The digits, minus sign, decimal point and "-inf" are rendered once (per font and scale factor)
+ * into a single channel image. Values are then drawn by blitting the glyph cells (tinted with the current colour),
+ * without any string allocation or glyph layout. All digits share the same cell width, so readouts don't jitter.
+ * Meters share their atlases through a GlyphAtlasCache.
+*/
+class GlyphAtlas final
+{
+public:
+    /**
+     * @brief Prepare the atlas for a font and scale factor.
+     *
+     * Only re-renders the glyphs when the font or scale factor changed.
+     *
+     * @param font  The font to render the glyphs with.
+     * @param scale The scale factor (physical pixels per logical pixel).
+    */
+    void prepare (const juce::Font& font, float scale);
+
+    /**
+     * @brief Check if the atlas is prepared for a font and scale factor.
+     *
+     * @param font  The font.
+     * @param scale The scale factor (physical pixels per logical pixel).
+     * @return True, if the glyphs are rendered with this font and scale factor.
+    */
+    [[nodiscard]] bool isPreparedFor (const juce::Font& font, float scale) const noexcept;
+
+    /**
+     * @brief Draw a value, centred in an area, in the current colour.
+     *
+     * Values at (or below) minus infinity are drawn as "-inf". The value is clipped to the area.
+     *
+     * @param[in,out] g                The juce graphics context to use.
+     * @param         value            The value to draw.
+     * @param         numDecimalPlaces The number of decimal places to draw.
+     * @param         bounds           The area to centre the value in.
+     * @param         minusInfinity_db The level drawn as minus infinity.
+    */
+    void drawValue (juce::Graphics& g, float value, int numDecimalPlaces, juce::Rectangle<int> bounds, float minusInfinity_db) const;
+
+private:
+    enum Glyphs
+    {
+        minusGlyph = 10,
+        pointGlyph,
+        minusInfinityGlyph,
+        numGlyphs
+    };
+
+    juce::Image                        m_image {};        // All glyph cells, side by side.
+    std::array<juce::Image, numGlyphs> m_glyphImages {};  // The cell of every glyph (sharing the pixels of the atlas).
+    std::array<float, numGlyphs>       m_glyphWidths {};  // The width of every cell (in logical pixels).
+    juce::Font                         m_font { juce::FontOptions {} };
+    float                              m_scale = 0.0f;
+
+    [[nodiscard]] static int getGlyph (char character) noexcept;
+
+    JUCE_LEAK_DETECTOR (GlyphAtlas)
+};
+
+//==============================================================================
+/**
+ * @brief The glyph atlases of the fonts and scale factors in use, shared by all meters.
+ *
+ * Every font and scale factor is rendered once, no matter how many meters draw values with it.
+ * Share the cache with a juce::SharedResourcePointer, and only use it from the message thread.
+*/
+class GlyphAtlasCache final
+{
+public:
+    /**
+     * @brief Get the atlas of a font and scale factor, rendering it when not in the cache yet.
+     *
+     * The atlas is only valid until the next call (it may be dropped to make room for another font or scale factor).
+     *
+     * @param font  The font to render the glyphs with.
+     * @param scale The scale factor (physical pixels per logical pixel).
+     * @return The atlas, prepared for the font and scale factor.
+    */
+    [[nodiscard]] const GlyphAtlas& getAtlas (const juce::Font& font, float scale);
+
+private:
+    static constexpr size_t kMaxNumAtlases = 8;  // Fonts and scale factors kept (e.g. for windows on screens with different scales).
+
+    std::vector<std::unique_ptr<GlyphAtlas>> m_atlases {};  // The most recently used first.
+
+    JUCE_LEAK_DETECTOR (GlyphAtlasCache)
+};
+}  // namespace SoundMeter
+}  // namespace sd
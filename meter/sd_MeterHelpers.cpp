@@ -54,6 +54,67 @@ juce::Rectangle<int> applyPadding (const juce::Rectangle<int>& rectToPad, Paddin
 }
 //==============================================================================
 
+juce::Range<float> getLevelRange (const std::vector<SegmentOptions>& segmentsOptions) noexcept
+{
+    if (segmentsOptions.empty())
+        return { Constants::kMinLevel_db, Constants::kMaxLevel_db };
+
+    auto levelRange = segmentsOptions.front().levelRange;
+    for (const auto& segmentOptions: segmentsOptions)
+        levelRange = levelRange.getUnionWith (segmentOptions.levelRange);
+
+    return levelRange;
+}
+//==============================================================================
+
+void mergeRectangles (std::vector<juce::Rectangle<int>>& rectangles, int maxRectangles)
+{
+    rectangles.erase (std::remove_if (rectangles.begin(), rectangles.end(), [] (const juce::Rectangle<int>& rect) { return rect.isEmpty(); }), rectangles.end());
+
+    auto getArea = [] (const juce::Rectangle<int>& rect) { return static_cast<juce::int64> (rect.getWidth()) * rect.getHeight(); };
+
+    const auto maxSize = static_cast<size_t> (std::max (1, maxRectangles));
+    while (rectangles.size() > maxSize)
+    {
+        // Find the neighbours that are cheapest to merge (the least area repainted needlessly)...
+        size_t      mergeIdx  = 0;
+        juce::int64 mergeCost = std::numeric_limits<juce::int64>::max();
+        for (size_t rectIdx = 0; rectIdx + 1 < rectangles.size(); ++rectIdx)
+        {
+            const auto& rect     = rectangles[rectIdx];
+            const auto& nextRect = rectangles[rectIdx + 1];
+            const auto  cost     = getArea (rect.getUnion (nextRect)) - getArea (rect) - getArea (nextRect);
+            if (cost < mergeCost)
+            {
+                mergeCost = cost;
+                mergeIdx  = rectIdx;
+            }
+        }
+
+        rectangles[mergeIdx] = rectangles[mergeIdx].getUnion (rectangles[mergeIdx + 1]);
+        rectangles.erase (rectangles.begin() + static_cast<std::ptrdiff_t> (mergeIdx + 1));
+    }
+}
+//==============================================================================
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_formats
+OfflineOptions getOfflineOptions (const Options& meterOptions, const std::vector<SegmentOptions>& segmentsOptions)
+{
+    OfflineOptions offlineOptions;
+    offlineOptions.frameRate                = static_cast<double> (meterOptions.refreshRate);
+    offlineOptions.ballistics               = meterOptions.ballistics;
+    offlineOptions.decayTime_ms             = meterOptions.decayTime_ms;
+    offlineOptions.peakDecayTime_ms         = meterOptions.peakDecayTime_ms;
+    offlineOptions.peakFallRate             = meterOptions.peakFallRate;
+    offlineOptions.levelRange               = getLevelRange (segmentsOptions);
+    offlineOptions.sampleAccurateBallistics = meterOptions.sampleAccurateBallistics;
+    offlineOptions.truePeakEnabled          = meterOptions.truePeakEnabled;
+    offlineOptions.loudnessEnabled          = meterOptions.loudnessEnabled;
+    return offlineOptions;
+}
+//==============================================================================
+#endif
+
 [[nodiscard]] static constexpr bool containsUpTo (juce::Range<float> levelRange, float levelDb) noexcept
 {
     return levelDb > levelRange.getStart() && levelDb <= levelRange.getEnd();
@@ -32,6 +32,9 @@
 
 #pragma once
 
+#include <sound_meter_core/sound_meter_core.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
 #include <juce_graphics/juce_graphics.h>
 
@@ -52,15 +55,14 @@ static constexpr auto kDefaultHeaderLabelWidth = 30;       ///< Default 'header'
 static constexpr auto kDefaultHeaderFontHeight = 14.0f;    ///< Default height of the font used in the 'header' part (in pixels).
 static constexpr auto kLabelStripTextPadding   = 2;        ///< Padding around the text in a label strip (in pixels).
 static constexpr auto kFaderRightPadding       = 1;        ///< Padding (in pixels) on the right side of the channel faders.
-static constexpr auto kMaxLevel_db             = 0.0f;     ///< Maximum meter level (in db).
-static constexpr auto kMinLevel_db             = -96.0f;   ///< Minimum meter level (in db).
-static constexpr auto kMinDecay_ms             = 100.0f;   ///< Minimum meter decay speed (in milliseconds).
-static constexpr auto kMaxDecay_ms             = 4000.0f;  ///< Maximum meter decay speed (in milliseconds).
-static constexpr auto kDefaultDecay_ms         = 1000.0f;  ///< Default meter decay speed (in milliseconds).
-static constexpr auto kPeakDefaultDecay_ms     = 2000.0f;  ///< Default meter decay speed (in milliseconds).
 static constexpr auto kTickMarkHeight          = 1;        ///< Height of a tick mark (in pixels).
 static constexpr auto kMinModeHeightThreshold = 150.0f;  ///< Meter minimum mode height threshold in pixels (min. mod is just the meter. not value, ticks or fader).
 static constexpr auto kMinModeWidthThreshold = 30.0f;  ///< Meter minimum mode width threshold in pixels (min. mod is just the meter. not value, ticks or fader).
+static constexpr auto kDefaultMaxRepaintRegions = 4;    ///< Maximum number of regions the meters panel repaints per refresh, when it repaints the meters itself and no maximum is set.
+static constexpr auto kDefaultLabelStripWidth  = 30;       ///< Default width of the label strip (in pixels).
+static constexpr auto kMeterGap                = 1;        ///< Space between neighbouring meters (in pixels).
+static constexpr auto kDefaultGroupGap         = 4;        ///< Default space between neighbouring groups of meters (in pixels).
+static constexpr auto kDefaultMinMeterWidth    = 4;        ///< Default minimum width of a meter (in pixels).
 }  // namespace Constants
 
 /**
@@ -102,11 +104,16 @@ struct Options
     bool  enabled          = true;  ///< Enable the meter.
     bool  valueEnabled     = false;  ///< Enable the 'value' part of the meter.
     float decayTime_ms     = Constants::kDefaultDecay_ms;  ///< Meter decay in milliseconds.
-    float peakDecayTime_ms = Constants::kPeakDefaultDecay_ms;  ///< Peak hold decay in milliseconds.
+    BallisticsType ballistics = BallisticsType::linear;  ///< Meter ballistics (the way the meter responds to level changes).
+    float peakDecayTime_ms = Constants::kPeakDefaultDecay_ms;  ///< Peak hold time in milliseconds. The peak hold shows the maximum level over this window.
+    float peakFallRate     = 0.0f;  ///< Rate (in dB/s) at which the peak hold falls back when it's maximum leaves the window. 0 falls back at once.
     float refreshRate      = 30.0f;                        ///< Meter refresh rate when using internal timing.
     bool  showPeakHoldIndicator  = true;  ///< Enable peak hold indicator.
     bool  showClipIndicator  = true;        ///< Enable clip indicator.
     juce::Colour clipIndicatorColor  = juce::Colours::crimson;
+    bool  truePeakEnabled    = false;  ///< Meter true-peak levels (4x over-sampled, ITU-R BS.1770) instead of sample peaks, when supplying buffers.
+    bool  loudnessEnabled    = false;  ///< Show a loudness meter (momentary loudness, EBU R128) next to the meters, when supplying buffers.
+    bool  sampleAccurateBallistics = false;  ///< Calculate the ballistics (decay and peak hold) on the audio thread, based on the sample rate, when supplying buffers.
     std::vector<float> tickMarks = { 0.0f, -3.0f, -6.0f, -9.0f, -12.0f, -18.0f, -30.0f, -40.0f, -50.0f };  ///< Tick-mark position in db.
 };
 
@@ -134,9 +141,9 @@ public:
     */
     [[nodiscard]] static std::vector<SegmentOptions> getDefaultScale()
     {
-        return { { { -60.0f, -18.0f }, { 0.0f, 0.5f }, juce::Colours::green, juce::Colours::green },
+        return { { { Constants::kDefaultScaleMin_db, -18.0f }, { 0.0f, 0.5f }, juce::Colours::green, juce::Colours::green },
                  { { -18.0f, -3.0f }, { 0.5f, 0.90f }, juce::Colours::green, juce::Colours::yellow },
-                 { { -3.0f, 0.0f }, { 0.90f, 1.0f }, juce::Colours::yellow, juce::Colours::red } };
+                 { { -3.0f, Constants::kMaxLevel_db }, { 0.90f, 1.0f }, juce::Colours::yellow, juce::Colours::red } };
     }
 
     /**
@@ -144,9 +151,9 @@ public:
      */
     [[nodiscard]] static std::vector<SegmentOptions> getSmpteScale()
     {
-        return { { { -44.0f, -12.0f }, { 0.0f, 0.7273f }, juce::Colours::green, juce::Colours::yellow },
+        return { { { Constants::kSmpteScaleMin_db, -12.0f }, { 0.0f, 0.7273f }, juce::Colours::green, juce::Colours::yellow },
                  { { -12.0f, -3.0f }, { 0.7273f, 0.9318f }, juce::Colours::yellow, juce::Colours::red },
-                 { { -3.0f, 0.0f }, { 0.9318f, 1.0f }, juce::Colours::red, juce::Colours::red } };
+                 { { -3.0f, Constants::kMaxLevel_db }, { 0.9318f, 1.0f }, juce::Colours::red, juce::Colours::red } };
     }
 
     /**
@@ -154,9 +161,21 @@ public:
      */
     [[nodiscard]] static std::vector<SegmentOptions> getYamaha60()
     {
-        return { { { -60.0f, -30.0f }, { 0.0f, 0.2751f }, juce::Colours::yellow, juce::Colours::yellow },
+        return { { { Constants::kYamaha60ScaleMin_db, -30.0f }, { 0.0f, 0.2751f }, juce::Colours::yellow, juce::Colours::yellow },
                  { { -30.0f, -18.0f }, { 0.2751f, 0.4521f }, juce::Colours::yellow, juce::Colours::yellow },
-                 { { -18.0f, 0.0f }, { 0.4521f, 1.0f }, juce::Colours::red, juce::Colours::red } };
+                 { { -18.0f, Constants::kMaxLevel_db }, { 0.4521f, 1.0f }, juce::Colours::red, juce::Colours::red } };
+    }
+
+    /**
+     * @brief Loudness meter scale (in LUFS). 3 segments, from -60 LUFS to 0 LUFS.
+     *
+     * Green up to the EBU R128 target level (-23 LUFS), yellow up to -14 LUFS and red above that.
+     */
+    [[nodiscard]] static std::vector<SegmentOptions> getLufsScale()
+    {
+        return { { { -60.0f, -23.0f }, { 0.0f, 0.6167f }, juce::Colours::green, juce::Colours::green },
+                 { { -23.0f, -14.0f }, { 0.6167f, 0.7667f }, juce::Colours::yellow, juce::Colours::yellow },
+                 { { -14.0f, 0.0f }, { 0.7667f, 1.0f }, juce::Colours::yellow, juce::Colours::red } };
     }
 
 private:
@@ -170,18 +189,65 @@ enum class NotificationOptions
     dontNotify  ///< Do not notify any listeners.
 };
 
+/** @brief How the meters panel renders it's meters. */
+enum class RenderMode
+{
+    components,      ///< Every meter (and the label strip) is a component of it's own, with it's own image cache.
+    singleComponent  ///< The panel draws all meters itself, in a single paint, into one backing image.
+};
+
+/** @brief How the meter bars are rasterized, when the panel draws all meters itself (see RenderMode::singleComponent). */
+enum class Rasterizer
+{
+    graphics,     ///< The bars are drawn with juce::Graphics.
+    bitmap,       ///< The bars are written straight into the pixels of a software backing image, filling rows with SIMD.
+    bitmapScalar  ///< Like bitmap, but blending pixel by pixel. The pixel exact reference for the bitmap rasterizer.
+};
+
 /** @brief Position of the label strip. */
 enum class LabelStripPosition
 {
     left,   ///< Left of the meters.
     right,  ///< Right of the meters.
     none,   ///< No label strip will be shown.
-    center
+    center  ///< In between the meters (with half of the meters on either side).
 };
 
 namespace Helpers
 {
 [[nodiscard]] juce::Rectangle<int> applyPadding (const juce::Rectangle<int>& rectToPad, Padding paddingToApply) noexcept;
+
+/**
+ * @brief Get the level range spanned by a set of segments.
+ *
+ * @param segmentsOptions The options of the segments.
+ * @return The union of the level ranges of all segments (in decibels), or the default meter range when there are no segments.
+*/
+[[nodiscard]] juce::Range<float> getLevelRange (const std::vector<SegmentOptions>& segmentsOptions) noexcept;
+
+/**
+ * @brief Merge rectangles, until no more than a maximum number of them is left.
+ *
+ * Repeatedly merges the pair of neighbouring rectangles (in the order given) whose union adds the least area.
+ * Meters are laid out side by side, so neighbours in the list are neighbours on screen.
+ *
+ * @param[in,out] rectangles    The rectangles to merge. Empty rectangles are removed.
+ * @param         maxRectangles The maximum number of rectangles to keep (at least one).
+*/
+void mergeRectangles (std::vector<juce::Rectangle<int>>& rectangles, int maxRectangles);
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_formats
+/**
+ * @brief Get the options to meter a file offline exactly like the meters would.
+ *
+ * The refresh rate of the meters becomes the frame rate of the offline meter.
+ *
+ * @param meterOptions    The meter options (ballistics, peak hold, true-peak, etc...).
+ * @param segmentsOptions The segments of the meters, defining the level range.
+ * @return The offline meter options.
+*/
+[[nodiscard]] OfflineOptions getOfflineOptions (const Options& meterOptions, const std::vector<SegmentOptions>& segmentsOptions);
+#endif
 }
 
 }  // namespace SoundMeter
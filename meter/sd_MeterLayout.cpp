@@ -0,0 +1,140 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterLayout.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+void MeterLayout::setOptions (const LayoutOptions& options)
+{
+    m_options   = options;
+    m_numMeters = -1;  // Lay out again at the next request.
+}
+//==============================================================================
+
+const MeterLayout::Layout& MeterLayout::getLayout (juce::Rectangle<int> area, int numMeters, LabelStripPosition labelStripPosition)
+{
+    if (area != m_area || numMeters != m_numMeters || labelStripPosition != m_labelStripPosition)
+    {
+        m_area               = area;
+        m_numMeters          = std::max (0, numMeters);
+        m_labelStripPosition = labelStripPosition;
+        calculate();
+    }
+
+    return m_layout;
+}
+//==============================================================================
+
+void MeterLayout::calculate()
+{
+    const auto numMeters       = static_cast<size_t> (m_numMeters);
+    const auto minMeterWidth   = std::max (1, m_options.minMeterWidth);
+    const auto labelStripWidth = m_labelStripPosition == LabelStripPosition::none ? 0 : std::clamp (m_options.labelStripWidth, 0, m_area.getWidth());
+    auto       area            = m_area;
+
+    m_layout.meterBounds.assign (numMeters, {});
+    m_layout.labelStripBounds = {};
+    m_layout.numVisibleMeters = 0;
+
+    if (m_labelStripPosition == LabelStripPosition::left)
+        m_layout.labelStripBounds = area.removeFromLeft (labelStripWidth);
+    else if (m_labelStripPosition == LabelStripPosition::right)
+        m_layout.labelStripBounds = area.removeFromRight (labelStripWidth);
+
+    const auto isCentered = m_labelStripPosition == LabelStripPosition::center;
+    const auto freeWidth  = area.getWidth() - (isCentered ? labelStripWidth : 0);
+
+    // The gap in front of every meter: a group gap at the start of a group, a meter gap otherwise...
+    m_gaps.assign (numMeters, std::max (0, m_options.meterGap));
+    size_t groupStart = 0;
+    for (const auto groupSize: m_options.groupSizes)
+    {
+        groupStart += static_cast<size_t> (std::max (0, groupSize));
+        if (groupStart >= numMeters)
+            break;
+        m_gaps[groupStart] = std::max (0, m_options.groupGap);
+    }
+    if (!m_gaps.empty())
+        m_gaps.front() = 0;
+
+    // With the label strip in the center, it takes the place of the gap in the middle of the visible meters.
+    auto getCenterIdx = [] (int numVisible) { return (numVisible + 1) / 2; };
+
+    // Find how many meters fit at their minimum width...
+    int gapsWidth = 0;
+    for (int meterIdx = 0; meterIdx < m_numMeters; ++meterIdx)
+    {
+        const auto numVisible   = meterIdx + 1;
+        gapsWidth              += m_gaps[static_cast<size_t> (meterIdx)];
+        const auto centerIdx    = getCenterIdx (numVisible);
+        const auto replacedGap  = isCentered && centerIdx < numVisible ? m_gaps[static_cast<size_t> (centerIdx)] : 0;
+        if (numVisible * minMeterWidth + gapsWidth - replacedGap > freeWidth)
+            break;
+        m_layout.numVisibleMeters = numVisible;
+    }
+
+    const auto numVisible  = m_layout.numVisibleMeters;
+    const auto centerIdx   = isCentered ? getCenterIdx (numVisible) : -1;
+    int        totalGaps   = 0;
+    for (int meterIdx = 1; meterIdx < numVisible; ++meterIdx)
+        totalGaps += meterIdx == centerIdx ? 0 : m_gaps[static_cast<size_t> (meterIdx)];
+
+    // ... and share the rest of the width, spreading the left-over pixels evenly.
+    const auto metersWidth = static_cast<juce::int64> (std::max (0, freeWidth - totalGaps));
+    auto       x           = area.getX();
+    for (int meterIdx = 0; meterIdx < numVisible; ++meterIdx)
+    {
+        if (meterIdx == centerIdx)
+        {
+            m_layout.labelStripBounds = { x, area.getY(), labelStripWidth, area.getHeight() };
+            x += labelStripWidth;
+        }
+        else
+        {
+            x += m_gaps[static_cast<size_t> (meterIdx)];
+        }
+
+        const auto meterLeft  = static_cast<int> (metersWidth * meterIdx / numVisible);
+        const auto meterRight = static_cast<int> (metersWidth * (meterIdx + 1) / numVisible);
+        m_layout.meterBounds[static_cast<size_t> (meterIdx)] = { x, area.getY(), meterRight - meterLeft, area.getHeight() };
+        x += meterRight - meterLeft;
+    }
+
+    if (centerIdx == numVisible)
+        m_layout.labelStripBounds = { x, area.getY(), labelStripWidth, area.getHeight() };
+}
+//==============================================================================
+}  // namespace SoundMeter
+}  // namespace sd
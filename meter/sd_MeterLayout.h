@@ -0,0 +1,112 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include "sd_MeterHelpers.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_graphics/juce_graphics.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief Options of the layout of the meters (and label strip) in the meters panel.
+*/
+struct LayoutOptions
+{
+    int              minMeterWidth   = Constants::kDefaultMinMeterWidth;    ///< Minimum width of a meter (in pixels). Meters that don't fit are hidden.
+    int              meterGap        = Constants::kMeterGap;                ///< Space between neighbouring meters (in pixels).
+    int              groupGap        = Constants::kDefaultGroupGap;         ///< Space between neighbouring groups of meters (in pixels).
+    std::vector<int> groupSizes      {};                                    ///< The number of meters in each consecutive group. The meters after the last group form a group of their own.
+    int              labelStripWidth = Constants::kDefaultLabelStripWidth;  ///< Width of the label strip (in pixels).
+};
+
+/**
+ * @brief Lays out any number of meters side by side, in a single pass.
+ *
+ * The meters share the width left after the label strip and the gaps. All edges are snapped to whole pixels,
+ * with the left-over pixels spread evenly over the meters, so neighbouring meters never differ more than a pixel in width.
+ * When the meters don't fit at their minimum width, the meters at the end are hidden (get empty bounds).
+ *
+ * The layout is cached, and only calculated again when the area, number of meters or options change.
+*/
+class MeterLayout final
+{
+public:
+    /** @brief The calculated layout. */
+    struct Layout
+    {
+        std::vector<juce::Rectangle<int>> meterBounds {};       ///< The bounds of every meter (empty for hidden meters).
+        juce::Rectangle<int>              labelStripBounds {};  ///< The bounds of the label strip (empty when not shown).
+        int                               numVisibleMeters = 0;  ///< The number of meters (from the start) that fit.
+    };
+
+    /**
+     * @brief Set the layout options.
+     *
+     * @param options The layout options to use.
+    */
+    void setOptions (const LayoutOptions& options);
+
+    /**
+     * @brief Get the layout options.
+     * @return The layout options.
+    */
+    [[nodiscard]] const LayoutOptions& getOptions() const noexcept { return m_options; }
+
+    /**
+     * @brief Get the layout of the meters (and label strip) in an area.
+     *
+     * @param area               The area to lay out the meters (and label strip) in.
+     * @param numMeters          The number of meters.
+     * @param labelStripPosition The position of the label strip (LabelStripPosition::none to leave it out).
+     * @return The layout. Stays valid until the next call.
+    */
+    [[nodiscard]] const Layout& getLayout (juce::Rectangle<int> area, int numMeters, LabelStripPosition labelStripPosition);
+
+private:
+    LayoutOptions        m_options {};
+    Layout               m_layout {};
+    std::vector<int>     m_gaps {};  // The gap in front of every meter (the first one is always 0).
+    juce::Rectangle<int> m_area {};
+    int                  m_numMeters          = -1;
+    LabelStripPosition   m_labelStripPosition = LabelStripPosition::none;
+
+    void calculate();
+
+    JUCE_LEAK_DETECTOR (MeterLayout)
+};
+}  // namespace SoundMeter
+}  // namespace sd
@@ -38,26 +38,15 @@ namespace SoundMeter
 {
 Level::Level()
 {
+    createOwnBank();
     setMeterSegments (m_segmentOptions);
 }
 //==============================================================================
 
-void Level::drawMeter (juce::Graphics& g, const MeterColours& meterColours)
+void Level::drawMeter (juce::Graphics& g, const MeterColours& meterColours, const BitmapTarget* target /*= nullptr*/) const
 {
-    const auto currentTime = static_cast<int> (juce::Time::getMillisecondCounter());
-    const auto timePassed  = static_cast<float> (currentTime - static_cast<int> (m_previousPeakHoldTime));
-    m_totalPeakHoldTimePassed = m_totalPeakHoldTimePassed + timePassed;
-    m_previousPeakHoldTime = currentTime;
-    
-    if (m_totalPeakHoldTimePassed >= m_meterOptions.peakDecayTime_ms){
-        m_totalPeakHoldTimePassed = 0.0f;
-        resetPeakHold();
-    }
-    
-    setClipInd ();
-    
-    for (auto& segment: m_segments)
-        segment.draw (g, meterColours);
+    for (const auto& segment: m_segments)
+        segment.draw (g, m_meterLevel_db, m_peakHoldLevel_db, meterColours, target);
     
     if (!m_valueBounds.isEmpty())
         drawPeakValue (g, meterColours);
@@ -78,9 +67,9 @@ void Level::drawPeakValue (juce::Graphics& g, const MeterColours& meterColours)
         
     if (peak_db > m_meterRange.getStart())  // If active, present and enough space is available.
     {
-        const int precision = peak_db <= -10.0f ? 1 : 2;  // Set precision depending on peak value. NOLINT
+        const auto& glyphAtlas = m_glyphAtlases->getAtlas (g.getCurrentFont(), g.getInternalContext().getPhysicalPixelScaleFactor());
         g.setColour (meterColours.textValueColour);
-        g.drawFittedText (juce::String (peak_db, precision), m_valueBounds, juce::Justification::centred, 1);
+        glyphAtlas.drawValue (g, peak_db, getPeakValuePrecision (peak_db), m_valueBounds, Decibels::kMinusInfinity_db);
     }
 }
 //==============================================================================
@@ -96,8 +85,7 @@ void Level::drawClipInd (juce::Graphics& g, const MeterColours& meterColours) co
 
 void Level::setClipInd ()
 {
-    const auto peak_db = getPeakHoldLevel();
-    if (peak_db >= 0.f){
+    if (m_bank->isClipping (m_channel) && !m_clip){
         m_clip = true;
         m_clipDirty = true;
     }
@@ -106,50 +94,132 @@ void Level::setClipInd ()
 
 void Level::resetClipInd ()
 {
+    m_bank->resetClip (m_channel);
     m_clip = false;
     m_clipDirty = true;
 }
 //==============================================================================
 
-float Level::getInputLevel()
+void Level::setInputLevel (float newLevel, int producer /*= 0*/) noexcept
 {
-    m_inputLevelRead.store (true);
-    return m_meterRange.clipValue (juce::Decibels::gainToDecibels (m_inputLevel.load()));
+    m_bank->setInputLevel (m_channel, newLevel, producer);
 }
 //==============================================================================
 
-void Level::setInputLevel (float newLevel)
+void Level::setInputBlockLevel (float blockPeak, int numSamples) noexcept
 {
-    m_inputLevel.store (m_inputLevelRead.load() ? newLevel : std::max (m_inputLevel.load(), newLevel));
-    m_inputLevelRead.store (false);
+    m_bank->setInputBlockLevel (m_channel, blockPeak, numSamples);
 }
 //==============================================================================
 
-float Level::getLinearDecayedLevel (float newLevel_db)
+void Level::setSampleRate (double sampleRate) noexcept
 {
-    const auto currentTime = static_cast<int> (juce::Time::getMillisecondCounter());
-    const auto timePassed  = static_cast<float> (currentTime - static_cast<int> (m_previousRefreshTime));
+    m_sampleRate = sampleRate;
+    if (m_ownBank)
+        m_ownBank->setSampleRate (sampleRate);
+}
+//==============================================================================
 
-    m_previousRefreshTime = currentTime;
-    
-    if (newLevel_db >= m_meterLevel_db)
-        return newLevel_db;
+void Level::setNumProducers (int numProducers)
+{
+    m_numProducers = numProducers;
+    if (m_ownBank)
+        m_ownBank->setNumProducers (numProducers);
+}
+//==============================================================================
+
+void Level::setClock (const Clock* clock) noexcept
+{
+    m_clock = clock;
+    if (m_ownBank)
+        m_ownBank->setClock (clock);
+}
+//==============================================================================
 
-    return std::max (newLevel_db, m_meterLevel_db - (timePassed * m_decayRate));
+void Level::setMeterBank (MeterBank* bank, int channel)
+{
+    // A view on a shared bank needs no bank of it's own...
+    if (bank != nullptr)
+    {
+        m_bank    = bank;
+        m_channel = channel;
+        m_ownBank.reset();
+    }
+    else
+    {
+        if (!m_ownBank)
+            createOwnBank();
+        m_channel = 0;
+    }
+
+    jassert (juce::isPositiveAndBelow (m_channel, m_bank->getNumChannels()));  // The channel should be part of the bank.
+
+    m_clip          = false;
+    m_valueDirty = true;
+    m_clipDirty     = true;
 }
 //==============================================================================
 
 void Level::refreshMeterLevel()
 {
+    if (m_ownBank)
+        m_ownBank->refresh();
+
+    if (!juce::isPositiveAndBelow (m_channel, m_bank->getNumChannels()))
+        return;
+
+    const auto meterLevel_db = m_bank->getMeterLevel (m_channel);
+    const auto peakHold_db   = m_bank->getPeakHoldLevel (m_channel);
+
+    if (meterLevel_db != m_meterLevel_db || peakHold_db != m_peakHoldLevel_db)
+        addDirtyStrips (meterLevel_db, peakHold_db);
+
+    if (peakHold_db != m_peakHoldLevel_db && isPeakValueChanged (peakHold_db))
+        m_valueDirty = true;
+
+    m_meterLevel_db    = meterLevel_db;
+    m_peakHoldLevel_db = peakHold_db;
+
     setClipInd();
-    
-    m_meterLevel_db = getLinearDecayedLevel (getInputLevel());
+}
+//==============================================================================
 
-    if (m_meterLevel_db > getPeakHoldLevel())
-        m_peakHoldDirty = true;
+void Level::addDirtyStrips (float meterLevel_db, float peakHold_db)
+{
+    // Only the strip between the old and new top of the bar, and the old and new peak hold lines, need a repaint.
+    // Both are rounded like they are drawn, so a move within the same pixel row repaints nothing...
+    for (const auto& segment: m_segments)
+    {
+        const auto oldLevelTop = segment.getLevelBounds (m_meterLevel_db).getY();
+        const auto newLevelTop = segment.getLevelBounds (meterLevel_db).getY();
+        if (!juce::exactlyEqual (oldLevelTop, newLevelTop))
+        {
+            const auto segmentBounds = segment.getSegmentBounds();
+            const auto strip         = juce::Rectangle<float>::leftTopRightBottom (segmentBounds.getX(), std::min (oldLevelTop, newLevelTop), segmentBounds.getRight(),
+                                                                                   std::max (oldLevelTop, newLevelTop));
+            m_dirtyBounds = m_dirtyBounds.getUnion (strip.toNearestIntEdges());
+        }
+
+        const auto oldPeakHoldBounds = segment.getPeakHoldBounds (m_peakHoldLevel_db);
+        const auto newPeakHoldBounds = segment.getPeakHoldBounds (peakHold_db);
+        if (oldPeakHoldBounds != newPeakHoldBounds)
+            m_dirtyBounds = m_dirtyBounds.getUnion (oldPeakHoldBounds.toNearestIntEdges()).getUnion (newPeakHoldBounds.toNearestIntEdges());
+    }
+}
+//==============================================================================
 
-    for (auto& segment: m_segments)
-        segment.setLevel (m_meterLevel_db);
+bool Level::isPeakValueChanged (float peakHold_db) const
+{
+    // The value is only repainted when it's text changes (or it appears or disappears)...
+    auto getText = [this] (float peak_db)
+    {
+        std::array<char, 32> text {};
+        if (peak_db > m_meterRange.getStart())
+            std::snprintf (text.data(), text.size(), "%.*f", getPeakValuePrecision (peak_db), static_cast<double> (peak_db));
+        return text;
+    };
+
+    return getText (peakHold_db) != getText (m_peakHoldLevel_db);
 }
 //==============================================================================
 
@@ -171,7 +241,9 @@ void Level::synchronizeMeterOptions()
         segment.setIsLabelStrip (m_isLabelStrip);
     }
 
-    m_peakHoldDirty = true;
+    m_dirtyBounds = m_levelBounds;
+
+    m_valueDirty = true;
 }
 //==============================================================================
 
@@ -179,11 +251,9 @@ void Level::setMeterSegments (const std::vector<SegmentOptions>& segmentsOptions
 {
     m_segments.clear();
     for (const auto& segmentOptions: segmentsOptions)
-    {
         m_segments.emplace_back (m_meterOptions, segmentOptions);
-        m_meterRange.setStart (std::min (m_meterRange.getStart(), segmentOptions.levelRange.getStart()));
-        m_meterRange.setEnd (std::max (m_meterRange.getEnd(), segmentOptions.levelRange.getEnd()));
-    }
+
+    m_meterRange = Helpers::getLevelRange (segmentsOptions);
     for (auto& segment: m_segments)
         segment.setMeterBounds (m_levelBounds);
     synchronizeMeterOptions();
@@ -193,9 +263,7 @@ void Level::setMeterSegments (const std::vector<SegmentOptions>& segmentsOptions
 
 void Level::reset()
 {
-    m_inputLevel.store (0.0f);
-    m_meterLevel_db       = Constants::kMinLevel_db;
-    m_previousRefreshTime = 0;
+    m_bank->reset (m_channel);
 }
 //==============================================================================
 
@@ -224,19 +292,10 @@ void Level::setDecay (float decay_ms)
 
 void Level::resetPeakHold()
 {
-    for (auto& segment: m_segments)
-        segment.resetPeakHold();
-    m_peakHoldDirty = true;
-}
-//==============================================================================
-
-float Level::getPeakHoldLevel() const noexcept
-{
-    if (m_segments.empty())
-        return Constants::kMinLevel_db;
-
-    return m_segments[0].getPeakHold();
-    
+    m_bank->resetPeakHold (m_channel);
+    addDirtyStrips (m_meterLevel_db, Constants::kMinLevel_db);
+    m_peakHoldLevel_db = Constants::kMinLevel_db;
+    m_valueDirty = true;
 }
 //==============================================================================
 
@@ -260,6 +319,7 @@ void Level::setMeterBounds (const juce::Rectangle<int>& bounds)
     
     for (auto& segment: m_segments)
         segment.setMeterBounds (m_levelBounds);
+    m_dirtyBounds = m_levelBounds;
     
     if (m_meterOptions.showClipIndicator)
         m_clipIndBounds.setHeight(6);
@@ -267,7 +327,7 @@ void Level::setMeterBounds (const juce::Rectangle<int>& bounds)
     if (m_isLabelStrip)
         m_clipIndBounds = juce::Rectangle<int>();
 
-    m_peakHoldDirty = true;
+    m_valueDirty = true;
     m_clipDirty = true;
     
 }
@@ -275,17 +335,13 @@ void Level::setMeterBounds (const juce::Rectangle<int>& bounds)
 
 juce::Rectangle<int> Level::getDirtyBounds()
 {
-    juce::Rectangle<int> dirtyBounds {};
-    for (const auto& segment: m_segments)
-    {
-        if (segment.isDirty())
-            dirtyBounds = dirtyBounds.getUnion (segment.getSegmentBounds().toNearestIntEdges());
-    }
+    auto dirtyBounds = m_dirtyBounds;
+    m_dirtyBounds    = {};
 
-    if (m_peakHoldDirty)
+    if (m_valueDirty)
     {
         dirtyBounds     = dirtyBounds.getUnion (m_valueBounds);
-        m_peakHoldDirty = false;
+        m_valueDirty = false;
     }
     
     if (m_clipDirty)
@@ -302,9 +358,31 @@ void Level::calculateDecayCoeff (const Options& meterOptions)
 {
     m_meterOptions.decayTime_ms = juce::jlimit (Constants::kMinDecay_ms, Constants::kMaxDecay_ms, meterOptions.decayTime_ms);
     m_meterOptions.refreshRate  = std::max (1.0f, meterOptions.refreshRate);
-    m_refreshPeriod_ms          = (1.0f / m_meterOptions.refreshRate) * 1000.0f;  // NOLINT
 
-    m_decayRate = m_meterRange.getLength() / m_meterOptions.decayTime_ms;
+    if (m_ownBank)
+        configureOwnBank();
+}
+//==============================================================================
+
+void Level::createOwnBank()
+{
+    m_ownBank = std::make_unique<MeterBank> (1);
+    m_ownBank->setNumProducers (m_numProducers);
+    m_ownBank->setSampleRate (m_sampleRate);
+    m_ownBank->setClock (m_clock);
+    configureOwnBank();
+
+    m_bank = m_ownBank.get();
+}
+//==============================================================================
+
+void Level::configureOwnBank()
+{
+    m_ownBank->setLevelRange (m_meterRange);
+    m_ownBank->setBallistics (m_meterOptions.ballistics, m_meterOptions.decayTime_ms);
+    m_ownBank->setPeakHoldTime (m_meterOptions.peakDecayTime_ms);
+    m_ownBank->setPeakFallRate (m_meterOptions.peakFallRate);
+    m_ownBank->setSampleAccurate (m_meterOptions.sampleAccurateBallistics);
 }
 //==============================================================================
 
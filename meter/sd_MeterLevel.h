@@ -33,6 +33,7 @@
 #pragma once
 
 #include "sd_MeterHelpers.h"
+#include "sd_MeterGlyphAtlas.h"
 #include "sd_MeterSegment.h"
 
 #include <juce_audio_basics/juce_audio_basics.h>
@@ -48,6 +49,9 @@ struct Options;
 /**
  * @brief Class responsible for anything relating to the 'meter' and peak 'value' parts.
  * This also includes the peak hold indicator and the tick-marks.
+ *
+ * The levels themselves are kept in a MeterBank. A standalone Level has it's own (single channel) bank,
+ * but a Level can also be a view on a channel of a shared bank (see setMeterBank), in which case it has no bank of it's own.
 */
 class Level final
 {
@@ -70,28 +74,116 @@ public:
      * Here the level is actually set from the audio engine.
      * Beware: very likely called from the audio thread!
      *
+     * The level is accumulated (the maximum is kept) until it is read with getInputLevel,
+     * so no peak in between two reads is lost.
+     *
+     * Multiple threads can safely set the level simultaneously. When a lot of threads
+     * feed the same meter, give each its own producer slot (see setNumProducers) to avoid contention.
+     * With a shared bank, this sets the level of the bank's channel.
+     *
      * @param newLevel The peak level from the audio engine (in amp).
+     * @param producer The index of the producer (thread) setting the level.
+     *
+     * @see getInputLevel, setNumProducers
+    */
+    void setInputLevel (float newLevel, int producer = 0) noexcept;
+
+    /**
+     * @brief Set the number of producers (threads) feeding this meter.
+     *
+     * Every producer gets it's own accumulator (on it's own cache line), which are merged when the level is read.
+     * This configures the meter's own bank. A shared bank is configured by it's owner.
+     * Beware: this allocates, so never call this while the audio engine is setting levels!
+     *
+     * @param numProducers The number of producers.
+     *
+     * @see setInputLevel, getNumProducers
+    */
+    void setNumProducers (int numProducers);
+
+    /**
+     * @brief Get the number of producers (threads) feeding this meter.
+     *
+     * @return The number of producers.
+     *
+     * @see setNumProducers
+    */
+    [[nodiscard]] int getNumProducers() const noexcept { return m_bank->getNumProducers(); }
+
+    /**
+     * @brief Set the level of a block of audio and calculate the ballistics.
+     *
+     * Used with sample accurate ballistics (see Options::sampleAccurateBallistics).
+     * The decay and peak hold are integrated over the duration of the block (based on the sample rate),
+     * so the meter's motion does not depend on when (or how often) the meter is refreshed.
+     * Beware: called from the audio thread! Only one thread should feed a meter this way.
+     *
+     * @param blockPeak  The peak level of the block (in amp).
+     * @param numSamples The number of samples in the block.
+     *
+     * @see setSampleRate, refreshMeterLevel
+    */
+    void setInputBlockLevel (float blockPeak, int numSamples) noexcept;
+
+    /**
+     * @brief Set the sample rate of the audio feeding the meter.
+     *
+     * Used with sample accurate ballistics (see Options::sampleAccurateBallistics).
+     * This configures the meter's own bank. A shared bank is configured by it's owner.
+     *
+     * @param sampleRate The sample rate (in Hz).
      *
-     * @see getInputLevel
+     * @see setInputBlockLevel
     */
-    void setInputLevel (float newLevel);
+    void setSampleRate (double sampleRate) noexcept;
+
+    /**
+     * @brief Set the clock used to time the ballistics and the peak hold.
+     *
+     * The clock is not owned by the meter and should outlive it.
+     * Only used by a standalone meter: the clock is kept for the meter's own bank and does not affect a shared bank,
+     * which times all of it's meters and is configured by it's owner (see MeterBank::setClock, MetersComponent::setClock).
+     *
+     * @param clock The clock to use, or nullptr to use the default (high resolution, real-time) clock.
+     *
+     * @see Clock, ManualClock, setMeterBank
+    */
+    void setClock (const Clock* clock) noexcept;
+
+    /**
+     * @brief Use a channel of a shared bank, instead of the meter's own bank.
+     *
+     * The bank is not owned by the meter and should outlive it.
+     * The owner of the bank is responsible for configuring and refreshing it.
+     * The meter's own bank is released while a shared bank is used, and created again (with the meter's settings) when going back.
+     * Beware: going back to the own bank allocates, so never call this while the audio engine is setting levels!
+     *
+     * @param bank    The bank to use, or nullptr to use the meter's own bank.
+     * @param channel The channel of the bank to display.
+     *
+     * @see MeterBank
+    */
+    void setMeterBank (MeterBank* bank, int channel);
 
     /**
      * @brief Get's the meter's input level.
      *
+     * Returns the maximum of all levels set (by all producers) between the last two refreshes.
+     *
      * @return The meter's input level (in decibels).
      *
-     * @see setInputLevel
+     * @see setInputLevel, refreshMeterLevel
     */
-    [[nodiscard]] float getInputLevel();
+    [[nodiscard]] float getInputLevel() const noexcept { return m_bank->getInputLevel (m_channel); }
 
     /**
      * @brief Calculate the actual meter level (ballistics included).
      *
-     * Calculate the meter's level including ballistics.
-     * Instant attack, but decayed release.
+     * Calculate the meter's level including ballistics (see Options::ballistics).
+     * With sample accurate ballistics, the level calculated by the audio thread is picked up instead.
+     * With a shared bank, the level is only read (the owner refreshes the bank).
      *
-     * @see getMeterLevel, setDecay
+     * @see getMeterLevel, setDecay, setInputBlockLevel
     */
     void refreshMeterLevel();
 
@@ -139,7 +231,7 @@ public:
      * @return The current peak hold level (in decibels).
      * @see resetPeakHold, isPeakValueVisible, setPeakValueVisible, setPeakHoldVisible, isPeakHoldEnabled
     */
-    [[nodiscard]] float getPeakHoldLevel() const noexcept;
+    [[nodiscard]] float getPeakHoldLevel() const noexcept { return m_peakHoldLevel_db; }
 
     /**
      * @brief Sets the meter's refresh rate.
@@ -250,19 +342,24 @@ public:
     */
     void resetMouseOverValue() noexcept { m_mouseOverValue = false; }
 
+    /**
+     * @brief Reset 'mouse over' status of the 'clip indicator' part of the meter.
+    */
+    void resetMouseOverClipInd() noexcept { m_mouseOverClipInd = false; }
+
     /**
      * @brief Draws the meter.
      *
+     * Drawing is a pure function of the levels at the last refresh. All state changes
+     * (ballistics, peak hold expiry, clip latching) happen in refreshMeterLevel.
+     *
      * @param[in,out] g            The juce graphics context to use.     
      * @param         meterColours The colours to use to draw the meter.
+     * @param         target       When not a nullptr, the bars are written straight into this bitmap (see Rasterizer).
      *
-     * @see drawInactiveMeter, drawPeakValue, drawPeakHold, drawTickMarks, drawLabels
+     * @see refreshMeterLevel, drawPeakValue, drawClipInd
     */
-    
-    void resetMouseOverClipInd() noexcept { m_mouseOverClipInd = false; }
-
-    
-    void drawMeter (juce::Graphics& g, const MeterColours& meterColours);
+    void drawMeter (juce::Graphics& g, const MeterColours& meterColours, const BitmapTarget* target = nullptr) const;
 
     /**
      * @brief Draw the peak 'value'.
@@ -285,27 +382,35 @@ private:
     juce::Rectangle<int> m_meterBounds {};  // Bounds of the meter area.
     juce::Rectangle<int> m_levelBounds {};  // Bounds of the level area.
     juce::Rectangle<int> m_clipIndBounds {};  // Bounds of clip indicator area.
+    juce::SharedResourcePointer<GlyphAtlasCache> m_glyphAtlases {};  // Pre-rendered glyphs of the peak value (shared by all meters).
 
     
 
     // Meter levels...
-    std::atomic<float> m_inputLevel { 0.0f };  // Audio peak level.
-    std::atomic<bool>  m_inputLevelRead { false };
-    float              m_meterLevel_db       = Constants::kMinLevel_db;  // Current meter level.
-    bool               m_peakHoldDirty       = false;
+    std::unique_ptr<MeterBank> m_ownBank {};  // The meter's own bank (only when no shared bank is set).
+    MeterBank*         m_bank                = nullptr;     // The bank holding the levels (the meter's own, or a shared one).
+    int                m_channel             = 0;           // The channel of the bank displayed by this meter.
+    float              m_meterLevel_db       = Constants::kMinLevel_db;  // Meter level at the last refresh (drawn).
+    float              m_peakHoldLevel_db    = Constants::kMinLevel_db;  // Peak hold level at the last refresh (drawn).
+    juce::Rectangle<int> m_dirtyBounds {};  // Part of the level area that changed since the last repaint.
+    bool               m_valueDirty          = false;  // The peak value text changed since the last repaint.
     bool               m_clipDirty           = false;
     bool               m_mouseOverValue      = false;
     bool               m_mouseOverClipInd    = false;
     bool               m_isLabelStrip        = false;
-    float              m_refreshPeriod_ms    = (1.0f / m_meterOptions.refreshRate) * 1000.0f;  // NOLINT
-    int                m_previousRefreshTime = 0;
-    int                m_previousPeakHoldTime = 0; 
-    float              m_totalPeakHoldTimePassed = 0.0f;
-    float              m_decayRate           = 0.0f;  // Decay rate in dB/ms.
     bool               m_clip                = false; // Clip has occured
 
-    [[nodiscard]] float getLinearDecayedLevel (float newLevel_db);
+    // Settings of the meter's own bank (kept to set up a new one, when a shared bank is released)...
+    double             m_sampleRate          = 48000.0;
+    int                m_numProducers        = 1;
+    const Clock*       m_clock               = nullptr;
+
+    void                addDirtyStrips (float meterLevel_db, float peakHold_db);
+    [[nodiscard]] bool  isPeakValueChanged (float peakHold_db) const;
+    [[nodiscard]] static int getPeakValuePrecision (float peak_db) noexcept { return peak_db <= -10.0f ? 1 : 2; }  // NOLINT
     void                calculateDecayCoeff (const Options& meterOptions);
+    void                createOwnBank();
+    void                configureOwnBank();
     void                synchronizeMeterOptions();
 
     // clang-format on
@@ -52,172 +52,216 @@ void Segment::setSegmentOptions (SegmentOptions segmentOptions)
     jassert (segmentOptions.meterRange.getStart() >= 0.0f && segmentOptions.meterRange.getEnd() <= 1.0f && segmentOptions.meterRange.getLength() > 0.0f);  // NOLINT
 
     m_segmentOptions = segmentOptions;
+    m_gradientImage  = {};  // Re-render the gradient in the new colours...
+    m_labelImage     = {};  // ... and the labels at the new levels.
 
     if (!m_meterBounds.isEmpty())
         setMeterBounds (m_meterBounds);
-
-    m_isDirty = true;
 }
 
 //==============================================================================
 
-void Segment::draw (juce::Graphics& g, const MeterColours& meterColours)
+void Segment::draw (juce::Graphics& g, float level_db, float peakHold_db, const MeterColours& meterColours, const BitmapTarget* target /*= nullptr*/) const
 {
-    m_isDirty = false;
-
     if (m_isLabelStrip)
     {
         drawLabels (g, meterColours);
         return;
     }
 
-    if (!m_drawnBounds.isEmpty())
-    {
-        g.setGradientFill (m_gradientFill);
-        g.setOpacity(0.8);
-        g.fillRect (m_drawnBounds);
-    }
+    if (m_segmentBounds.isEmpty())
+        return;
+
+    drawGradient (g, getLevelBounds (level_db), target);
+
+    if (m_showPeakHold)
+        drawGradient (g, getPeakHoldBounds (peakHold_db), target);
+}
 
-    if (m_meterOptions.showPeakHoldIndicator && !m_peakHoldBounds.isEmpty())
+//==============================================================================
+
+void Segment::drawGradient (juce::Graphics& g, juce::Rectangle<float> bounds, const BitmapTarget* target) const
+{
+    const auto segmentBounds = m_segmentBounds.toNearestIntEdges();
+    const auto destBounds    = bounds.toNearestIntEdges().getIntersection (segmentBounds);
+    if (destBounds.isEmpty())
+        return;
+
+    if (target != nullptr && target->bitmap != nullptr)
     {
-        g.setGradientFill (m_gradientFill);
-        g.setOpacity(0.8);
-        g.fillRect (m_peakHoldBounds);
-        m_drawnPeakHoldBounds = m_peakHoldBounds;
+        // Fill the same physical pixels the blit would, every row in it's colour of the gradient...
+        getGradientImage (target->scale);
+        const auto segmentPosition = (segmentBounds.getPosition().toFloat() * target->scale).roundToInt() + target->origin;
+        const auto numRows         = static_cast<int> (m_colourColumn.size());
+        const auto fillBounds      = (((destBounds - segmentBounds.getPosition()).toFloat() * target->scale).toNearestIntEdges() + segmentPosition)
+                                  .getIntersection (target->clip)
+                                  .getIntersection ({ target->clip.getX(), segmentPosition.y, target->clip.getWidth(), numRows });
+        if (!fillBounds.isEmpty())
+            BitmapFill::fillRows (*target->bitmap, fillBounds, m_colourColumn.data() + (fillBounds.getY() - segmentPosition.y), target->useSimd);
+        return;
     }
+
+    // Blit the part of the pre-rendered gradient, one image pixel per physical pixel...
+    const auto  scale        = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto& image        = getGradientImage (scale);
+    const auto  sourceBounds = ((destBounds - segmentBounds.getPosition()).toFloat() * scale).toNearestIntEdges().getIntersection (image.getBounds());
+
+    g.setOpacity (1.0f);
+    g.drawImage (image, destBounds.getX(), destBounds.getY(), destBounds.getWidth(), destBounds.getHeight(), sourceBounds.getX(), sourceBounds.getY(),
+                 sourceBounds.getWidth(), sourceBounds.getHeight());
 }
 
 //==============================================================================
 
-void Segment::drawLabels (juce::Graphics& g, const MeterColours& meterColours) const
+const juce::Image& Segment::getGradientImage (float scale) const
 {
-    g.setColour (juce::Colours::lightgrey);
-    
-    const float fontsize = 12;
-    g.setFont (fontsize);
-    
-    for (const auto& tickMark: m_tickMarks)
+    if (m_gradientImage.isValid() && juce::exactlyEqual (scale, m_gradientImageScale))
+        return m_gradientImage;
+
+    const auto segmentBounds = m_segmentBounds.toNearestIntEdges();
+    const auto width         = std::max (1, juce::roundToInt (static_cast<float> (segmentBounds.getWidth()) * scale));
+    const auto height        = std::max (1, juce::roundToInt (static_cast<float> (segmentBounds.getHeight()) * scale));
+
+    m_gradientImage      = juce::Image (juce::Image::ARGB, width, height, true);
+    m_gradientImageScale = scale;
+
     {
-        const auto tickMarkLevelRatio = std::clamp ((tickMark - m_segmentOptions.levelRange.getStart()) / m_segmentOptions.levelRange.getLength(), 0.0f, 1.0f);
-        
-        const auto tickMarkY = m_segmentBounds.getY() + m_segmentBounds.proportionOfHeight (1.0f - tickMarkLevelRatio);
-        
-        const auto tickLabelString = juce::String (std::abs (tickMark));
-        
-        const auto strWidth = g.getCurrentFont().getStringWidth(tickLabelString);
-        
-        int tickWidth = floor((m_meterBounds.getWidth() - strWidth)/2)-2;
-        
-        const auto leftTickMarkBounds = juce::Rectangle<float> (m_meterBounds.getX(),
-                                                                tickMarkY,
-                                                                tickWidth,
-                                                                static_cast<float> (Constants::kTickMarkHeight));
-        g.fillRect (leftTickMarkBounds);
-        const auto rightTickMarkBounds = juce::Rectangle<float> (m_meterBounds.getX()+m_meterBounds.getWidth()-tickWidth, 
-                                                                 tickMarkY,
-                                                                 tickWidth,
-                                                                 static_cast<float> (Constants::kTickMarkHeight));
-        g.fillRect (rightTickMarkBounds);
-        
-        const auto labelBounds        = juce::Rectangle<float> (0, tickMarkY - (fontsize / 2.0f), m_meterBounds.getWidth(), fontsize);
-                    
-        g.drawFittedText (tickLabelString, labelBounds.reduced (Constants::kLabelStripTextPadding, 0).toNearestInt(), juce::Justification::centred, 1);
+        juce::Graphics imageGraphics (m_gradientImage);
+        imageGraphics.setGradientFill (juce::ColourGradient (m_segmentOptions.segmentColour.withMultipliedAlpha (kGradientOpacity), 0.0f, static_cast<float> (height),
+                                                             m_segmentOptions.nextSegmentColour.withMultipliedAlpha (kGradientOpacity), 0.0f, 0.0f, false));
+        imageGraphics.fillAll();
     }
+
+    // The gradient is vertical, so one column holds the colours of all rows...
+    const juce::Image::BitmapData gradientData (m_gradientImage, 0, 0, 1, height, juce::Image::BitmapData::readOnly);
+    m_colourColumn.resize (static_cast<size_t> (height));
+    for (int y = 0; y < height; ++y)
+        m_colourColumn[static_cast<size_t> (y)] = *reinterpret_cast<const juce::PixelARGB*> (gradientData.getPixelPointer (0, y));  // NOLINT
+
+    return m_gradientImage;
 }
+
 //==============================================================================
 
-void Segment::setMeterBounds (juce::Rectangle<int> meterBounds)
+void Segment::drawLabels (juce::Graphics& g, const MeterColours& meterColours) const
 {
-    m_meterBounds            = meterBounds;
-    auto       floatBounds   = meterBounds.toFloat();
-    const auto segmentBounds = floatBounds.withY (floatBounds.getY() + floatBounds.proportionOfHeight (1.0f - m_segmentOptions.meterRange.getEnd()))
-                                 .withHeight (floatBounds.proportionOfHeight (m_segmentOptions.meterRange.getLength()));
-    m_segmentBounds = segmentBounds;
-    updateLevelBounds();
-    updatePeakHoldBounds();
+    juce::ignoreUnused (meterColours);
 
-    m_gradientFill = juce::ColourGradient (m_segmentOptions.segmentColour, segmentBounds.getBottomLeft(), m_segmentOptions.nextSegmentColour, segmentBounds.getTopLeft(), false);
+    if (m_tickMarks.empty())
+        return;
+
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!m_labelImage.isValid() || !juce::exactlyEqual (scale, m_labelImageScale))
+        renderLabels (scale);
 
-    m_isDirty = true;
+    g.setOpacity (1.0f);
+    g.drawImage (m_labelImage, m_labelBounds.getX(), m_labelBounds.getY(), m_labelBounds.getWidth(), m_labelBounds.getHeight(), 0, 0, m_labelImage.getWidth(),
+                 m_labelImage.getHeight());
 }
 //==============================================================================
 
-void Segment::setLevel (float level_db)
+void Segment::renderLabels (float scale) const
 {
-    if (level_db != m_currentLevel_db)
+    struct Label
     {
-        m_currentLevel_db = level_db;
-        updateLevelBounds();
+        juce::Rectangle<float> leftTickMarkBounds;
+        juce::Rectangle<float> rightTickMarkBounds;
+        juce::Rectangle<int>   textBounds;
+        juce::String           text;
+    };
+
+    // Lay out the tick marks and their labels...
+    const juce::Font       font (juce::FontOptions (kLabelFontSize));
+    std::vector<Label>     labels;
+    juce::Rectangle<float> layerBounds;
+    for (const auto& tickMark: m_tickMarks)
+    {
+        const auto tickMarkLevelRatio = std::clamp ((tickMark - m_segmentOptions.levelRange.getStart()) / m_segmentOptions.levelRange.getLength(), 0.0f, 1.0f);
+        const auto tickMarkY          = m_segmentBounds.getY() + m_segmentBounds.proportionOfHeight (1.0f - tickMarkLevelRatio);
+
+        Label label;
+        label.text = juce::String (std::abs (tickMark));
+
+        const auto strWidth  = font.getStringWidth (label.text);
+        const auto tickWidth = static_cast<float> (std::floor ((m_meterBounds.getWidth() - strWidth) / 2) - 2);
+
+        label.leftTickMarkBounds  = { static_cast<float> (m_meterBounds.getX()), tickMarkY, tickWidth, static_cast<float> (Constants::kTickMarkHeight) };
+        label.rightTickMarkBounds = { static_cast<float> (m_meterBounds.getRight()) - tickWidth, tickMarkY, tickWidth, static_cast<float> (Constants::kTickMarkHeight) };
+        label.textBounds          = juce::Rectangle<float> (0, tickMarkY - (kLabelFontSize / 2.0f), static_cast<float> (m_meterBounds.getWidth()), kLabelFontSize)
+                             .reduced (Constants::kLabelStripTextPadding, 0)
+                             .toNearestInt();
+
+        layerBounds = layerBounds.getUnion (label.leftTickMarkBounds).getUnion (label.rightTickMarkBounds).getUnion (label.textBounds.toFloat());
+        labels.push_back (label);
     }
 
-    if (level_db > m_peakHoldLevel_db)
+    // ... and render them once.
+    m_labelBounds     = layerBounds.getSmallestIntegerContainer();
+    m_labelImageScale = scale;
+    m_labelImage      = juce::Image (juce::Image::ARGB, std::max (1, juce::roundToInt (static_cast<float> (m_labelBounds.getWidth()) * scale)),
+                                     std::max (1, juce::roundToInt (static_cast<float> (m_labelBounds.getHeight()) * scale)), true);
+
+    juce::Graphics imageGraphics (m_labelImage);
+    imageGraphics.addTransform (juce::AffineTransform::translation (static_cast<float> (-m_labelBounds.getX()), static_cast<float> (-m_labelBounds.getY())).scaled (scale));
+    imageGraphics.setColour (juce::Colours::lightgrey);
+    imageGraphics.setFont (font);
+
+    for (const auto& label: labels)
     {
-        m_peakHoldLevel_db = level_db;
-        updatePeakHoldBounds();
+        imageGraphics.fillRect (label.leftTickMarkBounds);
+        imageGraphics.fillRect (label.rightTickMarkBounds);
+        imageGraphics.drawFittedText (label.text, label.textBounds, juce::Justification::centred, 1);
     }
 }
 //==============================================================================
 
-void Segment::updateLevelBounds()
+void Segment::setMeterBounds (juce::Rectangle<int> meterBounds)
 {
-    if (m_segmentBounds.isEmpty())
-        return;
-
-    const auto levelRatio  = std::clamp ((m_currentLevel_db - m_segmentOptions.levelRange.getStart()) / m_segmentOptions.levelRange.getLength(), 0.0f, 1.0f);
-    const auto levelBounds = m_segmentBounds.withTop (m_segmentBounds.getY() + m_segmentBounds.proportionOfHeight (1.0f - levelRatio));
-
-    if (m_drawnBounds == levelBounds)
-        return;
+    m_meterBounds            = meterBounds;
+    auto       floatBounds   = meterBounds.toFloat();
+    const auto segmentBounds = floatBounds.withY (floatBounds.getY() + floatBounds.proportionOfHeight (1.0f - m_segmentOptions.meterRange.getEnd()))
+                                 .withHeight (floatBounds.proportionOfHeight (m_segmentOptions.meterRange.getLength()));
+    m_segmentBounds = segmentBounds;
 
-    m_drawnBounds = levelBounds;
-    m_isDirty     = true;
+    m_gradientImage = {};  // Re-render the gradient and labels at the new size.
+    m_labelImage    = {};
 }
 //==============================================================================
 
-void Segment::updatePeakHoldBounds()
+float Segment::getLevelRatio (float level_db) const noexcept
 {
-    auto peakHoldBounds = juce::Rectangle<float>();
-
-    if (Helpers::containsUpTo (m_segmentOptions.levelRange, m_peakHoldLevel_db))
-    {
-        const auto peakHoldRatio = std::clamp ((m_peakHoldLevel_db - m_segmentOptions.levelRange.getStart()) / m_segmentOptions.levelRange.getLength(), 0.0f, 1.0f);
-        if (peakHoldRatio == 0.0f)
-            return;
-
-        const auto peakHoldY = m_segmentBounds.getY() + m_segmentBounds.proportionOfHeight (1.0f - peakHoldRatio);
-        peakHoldBounds       = m_segmentBounds.withTop (peakHoldY).withHeight (Constants::kPeakHoldHeight);
-    }
-
-    if (peakHoldBounds == m_drawnPeakHoldBounds)
-        return;
+    return std::clamp ((level_db - m_segmentOptions.levelRange.getStart()) / m_segmentOptions.levelRange.getLength(), 0.0f, 1.0f);
+}
+//==============================================================================
 
-    m_peakHoldBounds = peakHoldBounds;
-    m_isDirty        = true;
+juce::Rectangle<float> Segment::getLevelBounds (float level_db) const noexcept
+{
+    return m_segmentBounds.withTop (m_segmentBounds.getY() + m_segmentBounds.proportionOfHeight (1.0f - getLevelRatio (level_db)));
 }
 //==============================================================================
 
-void Segment::resetPeakHold() noexcept
+juce::Rectangle<float> Segment::getPeakHoldBounds (float peakHold_db) const noexcept
 {
-    m_peakHoldBounds.setHeight (0);
-    m_peakHoldLevel_db    = Constants::kMinLevel_db;
-    m_drawnPeakHoldBounds = m_peakHoldBounds;
-    m_isDirty             = true;
+    if (!Helpers::containsUpTo (m_segmentOptions.levelRange, peakHold_db))
+        return {};
+
+    const auto peakHoldY = m_segmentBounds.getY() + m_segmentBounds.proportionOfHeight (1.0f - getLevelRatio (peakHold_db));
+    return m_segmentBounds.withTop (peakHoldY).withHeight (Constants::kPeakHoldHeight);
 }
 //==============================================================================
 
 void Segment::setMeterOptions (const Options& meterOptions)
 {
-    m_meterOptions = meterOptions;
+    m_showPeakHold = meterOptions.showPeakHoldIndicator;
 
     // Find all tickMark-marks in this segment's range...
+    m_labelImage = {};
     m_tickMarks.clear();
     for (const auto& tickMark: meterOptions.tickMarks)
     {
         if (Helpers::containsUpTo (m_segmentOptions.levelRange, tickMark))
             m_tickMarks.emplace_back (tickMark);
     }
-
-    m_isDirty = true;
 }
 //==============================================================================
 }  // namespace SoundMeter
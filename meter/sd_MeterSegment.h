@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include "sd_MeterBitmapFill.h"
 #include "sd_MeterHelpers.h"
 
 #include <juce_core/juce_core.h>
@@ -43,18 +44,34 @@ namespace sd  // NOLINT
 namespace SoundMeter
 {
 
-
+/**
+ * @brief A segment of a meter: a level range, it's position within the meter and it's colour.
+ *
+ * A segment holds no level state. The level and peak hold are passed in when drawing,
+ * so all segments of a meter draw the same snapshot of the levels.
+ *
+ * The gradient of the segment is rendered into an image once (per size, colour and scale factor),
+ * so drawing the level is just a blit of the visible part of that image.
+ * Likewise, the tick marks and labels of a label strip are laid out and rendered once.
+ * When drawing into a BitmapTarget, the level is written straight into the target's pixels instead,
+ * a row at a time, using the colours of the pre-rendered gradient.
+*/
 class Segment final
 {
 public:
     /** @brief Construct a segment using the supplied options.*/
     Segment (const Options& meterOptions, const SegmentOptions& segmentOptions);
 
-    /** @brief Set the level in decibels.*/
-    void setLevel (float level_db);
-
-    /** @brief Draw the segment.*/
-    void draw (juce::Graphics& g, const MeterColours& meterColours);
+    /**
+     * @brief Draw the segment.
+     *
+     * @param[in,out] g             The juce graphics context to use.
+     * @param         level_db      The meter level (in decibels).
+     * @param         peakHold_db   The peak hold level (in decibels).
+     * @param         meterColours  The colours to use to draw the meter.
+     * @param         target        When not a nullptr, the level and peak hold are written straight into this bitmap (instead of drawn with g).
+    */
+    void draw (juce::Graphics& g, float level_db, float peakHold_db, const MeterColours& meterColours, const BitmapTarget* target = nullptr) const;
 
     /** @brief Set the bounds of the total meter (all segments) */
     void setMeterBounds (juce::Rectangle<int> meterBounds);
@@ -62,14 +79,11 @@ public:
     /** @brief Get the bounding box of this segment.*/
     [[nodiscard]] juce::Rectangle<float> getSegmentBounds() const noexcept { return m_segmentBounds; }
 
-    /** @brief Reset the peak hold.*/
-    void resetPeakHold() noexcept;
+    /** @brief Get the bounds of the level part of the segment.*/
+    [[nodiscard]] juce::Rectangle<float> getLevelBounds (float level_db) const noexcept;
 
-    /** @brief Get the peak hold level.*/
-    [[nodiscard]] float getPeakHold() const noexcept { return m_peakHoldLevel_db; }
-
-    /** @brief Check if the segment needs to be re-drawn (dirty). */
-    [[nodiscard]] bool isDirty() const noexcept { return m_isDirty; }
+    /** @brief Get the bounds of the peak hold indicator (empty when the peak hold is not in this segment).*/
+    [[nodiscard]] juce::Rectangle<float> getPeakHoldBounds (float peakHold_db) const noexcept;
 
     /**
      * @brief Set whether this meter is a label strip.
@@ -90,29 +104,33 @@ public:
     /** @brief Set meter options. */
     void setMeterOptions (const Options& meterOptions);
 
-    /** @brief Get segment options.*/
-    [[nodiscard]] Options getMeterOptions() const { return m_meterOptions; }
-
 private:
     SegmentOptions         m_segmentOptions {};
-    Options                m_meterOptions {};
     std::vector<float>     m_tickMarks {};
     juce::Rectangle<int>   m_meterBounds {};
     juce::Rectangle<float> m_segmentBounds {};
-    juce::Rectangle<float> m_drawnBounds {};
-    juce::Rectangle<float> m_peakHoldBounds {};
-    juce::Rectangle<float> m_drawnPeakHoldBounds {};
-    juce::ColourGradient   m_gradientFill {};
-
-    float m_currentLevel_db   = Constants::kMinLevel_db;
-    float m_peakHoldLevel_db  = Constants::kMinLevel_db;
-    bool  m_isDirty           = false;
+
+    // The full height gradient of the segment, rendered once per size, colour and scale factor.
+    mutable juce::Image    m_gradientImage {};
+    mutable float          m_gradientImageScale = 0.0f;
+    mutable std::vector<juce::PixelARGB> m_colourColumn {};  // The colour of every row of the gradient image.
+
+    // The tick marks and labels (of a label strip), rendered once per bounds, tick marks, font and scale factor.
+    mutable juce::Image          m_labelImage {};
+    mutable juce::Rectangle<int> m_labelBounds {};
+    mutable float                m_labelImageScale = 0.0f;
+
+    bool  m_showPeakHold      = true;
     bool  m_isLabelStrip      = false;
 
-    void updateLevelBounds();
-    void updatePeakHoldBounds();
-    void drawTickMarks (juce::Graphics& g, const MeterColours& meterColours);
+    static constexpr float kGradientOpacity = 0.8f;
+    static constexpr float kLabelFontSize   = 12.0f;
+
+    [[nodiscard]] float getLevelRatio (float level_db) const noexcept;
+    [[nodiscard]] const juce::Image& getGradientImage (float scale) const;
+    void drawGradient (juce::Graphics& g, juce::Rectangle<float> bounds, const BitmapTarget* target) const;
     void drawLabels (juce::Graphics& g, const MeterColours& meterColours) const;
+    void renderLabels (float scale) const;
 
     JUCE_LEAK_DETECTOR (Segment)
 };
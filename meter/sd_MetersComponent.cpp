@@ -37,13 +37,23 @@ namespace sd  // NOLINT
 namespace SoundMeter
 {
 MetersComponent::MetersComponent()
+  : MetersComponent (juce::AudioChannelSet::stereo())
+{
+}
+//==============================================================================
+
+MetersComponent::MetersComponent (const juce::AudioChannelSet& channelFormat)
     : m_meterOptions ({}),
-    m_labelStrip ({}, Padding (0, 0, 0, 0), "label_strip", true, juce::AudioChannelSet::ChannelType::unknown)
+    m_labelStrip ({}, Padding (0, 0, 0, 0), "label_strip", true, juce::AudioChannelSet::ChannelType::unknown),
+    m_loudnessMeter ({}, Padding (0, 0, 0, 0), "loudness_meter", false, juce::AudioChannelSet::ChannelType::unknown)
 {
     setName ("meters_panel");
     addAndMakeVisible (m_labelStrip);
+    addChildComponent (m_loudnessMeter);
+    m_loudnessMeter.setMeterSegments (MeterScales::getLufsScale());
+    setLoudnessMeterOptions (m_meterOptions);
     startTimerHz (static_cast<int> (std::round (m_meterOptions.refreshRate)));
-    createMeters (juce::AudioChannelSet::stereo(), {});
+    createMeters (channelFormat, {});
 }
 
 //==============================================================================
@@ -64,9 +74,8 @@ void MetersComponent::reset()
 
 void MetersComponent::clearMeters()
 {
-    for (auto* meter: m_meterChannels)
-        if (meter)
-            meter->setInputLevel (0.0f);
+    for (int channelIdx = 0; channelIdx < m_meterBank.getNumChannels(); ++channelIdx)
+        m_meterBank.reset (channelIdx);  // Setting an input level of 0 would be a no-op, since input levels accumulate their maximum.
 
     refresh (true);
 }
@@ -74,18 +83,61 @@ void MetersComponent::clearMeters()
 
 void MetersComponent::refresh (const bool forceRefresh /*= false*/)
 {
+    // Always pick up the finished loudness blocks, also while hidden, or the integrated loudness would get gaps once the FIFO fills up...
+    const auto loudnessEnabled = m_loudnessEnabled.load();
+    if (loudnessEnabled)
+        m_loudness.update();
+
     if (!isShowing() || m_meterChannels.isEmpty())
         return;
 
-    
+    m_meterBank.refresh();
+
+    m_dirtyRegions.clear();
+    refreshMeter (m_labelStrip, forceRefresh);
     for (auto* meter: m_meterChannels)
     {
         if (meter)
-            meter->refresh (forceRefresh);
+            refreshMeter (*meter, forceRefresh);
+    }
+
+    if (loudnessEnabled)
+    {
+        m_loudnessMeter.setInputLevel (juce::Decibels::decibelsToGain (m_loudness.getMomentaryLoudness()));
+        refreshMeter (m_loudnessMeter, forceRefresh);
+    }
+
+    if (!isCoalescingRepaints())
+        return;
+
+    // Repaint the dirty parts of all meters at once, in a few merged regions...
+    if (forceRefresh)
+    {
+        repaint();
+        return;
+    }
+
+    Helpers::mergeRectangles (m_dirtyRegions, m_maxRepaintRegions > 0 ? m_maxRepaintRegions : Constants::kDefaultMaxRepaintRegions);
+    for (const auto& dirtyRegion: m_dirtyRegions)
+        repaint (dirtyRegion);
+}
+//==============================================================================
+
+void MetersComponent::refreshMeter (MeterChannel& meter, bool forceRefresh)
+{
+    if (!isCoalescingRepaints())
+    {
+        meter.refresh (forceRefresh);
+        return;
     }
-    
-    m_labelStrip.refresh (forceRefresh);
 
+    // Collect the dirty parts of all meters (in panel coordinates), to repaint them in one go...
+    if (!meter.isVisible())
+        return;
+
+    const auto dirtyBounds = meter.refreshLevel();
+    if (!dirtyBounds.isEmpty())
+        m_dirtyRegions.push_back (dirtyBounds + meter.getPosition());
 }
 //==============================================================================
 
@@ -94,6 +146,7 @@ void MetersComponent::setRefreshRate (float refreshRate_hz)
     m_meterOptions.refreshRate = refreshRate_hz;
 
     m_labelStrip.setRefreshRate (static_cast<float> (refreshRate_hz));
+    m_loudnessMeter.setRefreshRate (static_cast<float> (refreshRate_hz));
     for (auto* meter: m_meterChannels)
         if (meter)
             meter->setRefreshRate (static_cast<float> (refreshRate_hz));
@@ -108,71 +161,331 @@ void MetersComponent::setRefreshRate (float refreshRate_hz)
 
 void MetersComponent::paint (juce::Graphics& g)
 {
+    if (m_renderMode != RenderMode::singleComponent)
+        return;
+
+    if (m_rasterizer == Rasterizer::graphics)
+        drawMeters (g, nullptr, 1.0f);
+    else
+        paintBitmap (g);
+}
+//==============================================================================
+
+void MetersComponent::paintBitmap (juce::Graphics& g)
+{
+    const auto scale  = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto width  = std::max (1, juce::roundToInt (static_cast<float> (getWidth()) * scale));
+    const auto height = std::max (1, juce::roundToInt (static_cast<float> (getHeight()) * scale));
+    if (m_backingImage.getWidth() != width || m_backingImage.getHeight() != height)
+        m_backingImage = juce::Image (juce::Image::ARGB, width, height, true, juce::SoftwareImageType());
+
+    // Redraw the part being repainted, in physical pixels...
+    const auto clipBounds = g.getClipBounds();
+    m_backingImage.clear ((clipBounds.toFloat() * scale).getSmallestIntegerContainer().getIntersection (m_backingImage.getBounds()));
+    {
+        juce::Image::BitmapData bitmap (m_backingImage, juce::Image::BitmapData::readWrite);
+        juce::Graphics          imageGraphics (m_backingImage);
+        imageGraphics.addTransform (juce::AffineTransform::scale (scale));
+        imageGraphics.reduceClipRegion (clipBounds);
+        drawMeters (imageGraphics, &bitmap, scale);
+    }
+
+    // ... and blit it, one image pixel per physical pixel.
+    g.drawImage (m_backingImage, 0, 0, getWidth(), getHeight(), 0, 0, width, height);
+}
+//==============================================================================
+
+void MetersComponent::drawMeters (juce::Graphics& g, juce::Image::BitmapData* bitmap, float scale) const
+{
+    auto drawMeter = [this, &g, bitmap, scale] (const MeterChannel& meter)
+    {
+        if (!meter.isVisible() || !g.clipRegionIntersects (meter.getBounds()))
+            return;
+
+        const juce::Graphics::ScopedSaveState savedState (g);
+        g.reduceClipRegion (meter.getBounds());
+        g.setOrigin (meter.getPosition());
+
+        if (bitmap == nullptr)
+        {
+            meter.drawMeter (g);
+            return;
+        }
+
+        // The bars go straight into the pixels, within the part of the meter being repainted...
+        BitmapTarget target;
+        target.bitmap  = bitmap;
+        target.origin  = (meter.getPosition().toFloat() * scale).roundToInt();
+        target.clip    = ((g.getClipBounds() + meter.getPosition()).toFloat() * scale).getSmallestIntegerContainer().getIntersection ({ bitmap->width, bitmap->height });
+        target.scale   = scale;
+        target.useSimd = m_rasterizer == Rasterizer::bitmap;
+        meter.drawMeter (g, &target);
+    };
+
+    drawMeter (m_labelStrip);
+    for (const auto* meter: m_meterChannels)
+    {
+        if (meter)
+            drawMeter (*meter);
+    }
+    drawMeter (m_loudnessMeter);
+}
+//==============================================================================
+
+void MetersComponent::mouseDown (const juce::MouseEvent& event)
+{
+    // Meters drawn by the panel are no components on screen, so pass the clicks on to them...
+    if (m_renderMode != RenderMode::singleComponent || event.eventComponent != this)
+        return;
+
+    for (auto* meter: m_meterChannels)
+    {
+        if (meter != nullptr && meter->isVisible() && meter->getBounds().contains (event.getPosition()))
+            static_cast<juce::Component*> (meter)->mouseDown (event.withNewPosition (event.position - meter->getPosition().toFloat()));
+    }
+}
+//==============================================================================
+
+void MetersComponent::setRenderMode (RenderMode renderMode)
+{
+    if (renderMode == m_renderMode)
+        return;
+
+    m_renderMode = renderMode;
+    attachMeters();
+    resized();
+    refresh (true);
+}
+//==============================================================================
+
+void MetersComponent::setRasterizer (Rasterizer rasterizer)
+{
+    if (rasterizer == m_rasterizer)
+        return;
+
+    m_rasterizer = rasterizer;
+    if (m_rasterizer == Rasterizer::graphics)
+        m_backingImage = {};
+
+    attachMeters();
+    refresh (true);
+}
+//==============================================================================
+
+void MetersComponent::setMaxRepaintRegions (int maxRegions)
+{
+    maxRegions = std::max (0, maxRegions);
+    if (maxRegions == m_maxRepaintRegions)
+        return;
+
+    m_maxRepaintRegions = maxRegions;
+    attachMeters();
+    refresh (true);
+}
+//==============================================================================
+
+void MetersComponent::setLabelStripPosition (LabelStripPosition labelStripPosition)
+{
+    if (labelStripPosition == m_labelStripPosition)
+        return;
+
+    m_labelStripPosition = labelStripPosition;
+    showLabelStrip();
+    resized();
+}
+//==============================================================================
+
+void MetersComponent::showLabelStrip()
+{
+    m_labelStrip.setVisible (m_meterOptions.enabled && m_labelStripPosition != LabelStripPosition::none);
+}
+//==============================================================================
+
+void MetersComponent::attachMeters()
+{
+    const auto singleComponent = m_renderMode == RenderMode::singleComponent;
+    const auto cacheMeters     = !isCoalescingRepaints();  // Meters repainted by the panel would draw a stale image cache.
+
+    // Meters drawn by the panel are no child components, so they are never painted, hit tested or cached on their own...
+    auto attachMeter = [this, singleComponent, cacheMeters] (MeterChannel& meter)
+    {
+        meter.setBufferedToImage (cacheMeters);
+        if (singleComponent)
+            removeChildComponent (&meter);
+        else
+            addChildComponent (meter);
+    };
+
+    attachMeter (m_labelStrip);
+    for (auto* meter: m_meterChannels)
+    {
+        if (meter)
+            attachMeter (*meter);
+    }
+    attachMeter (m_loudnessMeter);
+
+    // ... instead the panel caches all of them in one image (or renders into it's own, with the bitmap rasterizers).
+    setBufferedToImage (singleComponent && m_rasterizer == Rasterizer::graphics);
 }
 //==============================================================================
 
 void MetersComponent::resized()
 {
-    auto        panelBounds     = getLocalBounds().toFloat();
-    
-    m_labelStrip.setBounds(panelBounds.getX(), panelBounds.getY(), panelBounds.getWidth(), panelBounds.getHeight());
+    auto panelBounds = getLocalBounds();
+
+    if (m_loudnessMeter.isVisible())
+        m_loudnessMeter.setBounds (panelBounds.removeFromRight (panelBounds.getWidth() / 3).withTrimmedLeft (1));
 
-    const int   panelWidth      = panelBounds.getWidth();
-    int         meterWidth;
-    int         gap;
-    if (panelWidth % 2 == 0){
-        meterWidth = (panelWidth/2)-1;
-        gap = 2;
+    // The label strip gets a column of it's own, so no meter overlaps (and repaints) it.
+    // The meters share the rest, side by side (the layout is cached, so only calculated when the panel or the meters change)...
+    const auto  labelStripPosition = m_labelStrip.isVisible() ? m_labelStripPosition : LabelStripPosition::none;
+    const auto& layout             = m_layout.getLayout (panelBounds, m_meterChannels.size(), labelStripPosition);
+
+    m_labelStrip.setBounds (layout.labelStripBounds);
+    for (int meterIdx = 0; meterIdx < m_meterChannels.size(); ++meterIdx)
+    {
+        if (auto* meter = m_meterChannels[meterIdx])
+            meter->setBounds (layout.meterBounds[static_cast<size_t> (meterIdx)]);
     }
-    else {
-        meterWidth = (panelWidth-1)/2;
-        gap = 1;
+
+    if (m_renderMode == RenderMode::singleComponent)
+        repaint();
+}
+
+//==============================================================================
+
+void MetersComponent::setInputLevel (int channel, float value, int producer /*= 0*/)
+{
+    m_meterBank.setInputLevel (channel, value, producer);
+}
+//==============================================================================
+
+void MetersComponent::setInputBuffer (const juce::AudioBuffer<float>& buffer, int producer /*= 0*/)
+{
+    setInputBuffer (buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples(), producer);
+}
+//==============================================================================
+
+void MetersComponent::setInputBuffer (const float* const* channelData, int numChannels, int numSamples, int producer /*= 0*/)
+{
+    if (channelData == nullptr || numSamples <= 0)
+        return;
+
+    const auto truePeakEnabled = m_truePeakEnabled.load (std::memory_order_relaxed);
+    const auto sampleAccurate  = m_sampleAccurate.load (std::memory_order_relaxed);
+    const auto numMeters       = std::min (numChannels, m_meterBank.getNumChannels());
+    for (int channelIdx = 0; channelIdx < numMeters; ++channelIdx)
+    {
+        const auto* samples = channelData[channelIdx];
+        const auto  peak    = truePeakEnabled ? m_truePeakDetector.process (channelIdx, samples, numSamples) : Helpers::getPeakLevel (samples, numSamples);
+        if (sampleAccurate)
+            m_meterBank.setInputBlockLevel (channelIdx, peak, numSamples);
+        else
+            m_meterBank.setInputLevel (channelIdx, peak, producer);
     }
-    
-    m_meterChannels[0]->setBounds (panelBounds.removeFromLeft(meterWidth).toNearestIntEdges());
-    panelBounds.removeFromLeft(gap);
-    m_meterChannels[1]->setBounds (panelBounds.removeFromLeft(meterWidth).toNearestIntEdges());
+
+    if (m_loudnessEnabled.load (std::memory_order_relaxed))
+        m_loudness.process (channelData, numMeters, numSamples);
+}
+//==============================================================================
+
+void MetersComponent::setNumProducers (int numProducers)
+{
+    m_numProducers = std::max (1, numProducers);
+    m_meterBank.setNumProducers (m_numProducers);
 }
+//==============================================================================
+
+void MetersComponent::setSampleRate (double sampleRate)
+{
+    if (sampleRate <= 0.0)
+        return;
 
+    m_sampleRate = sampleRate;
+    m_loudness.prepare (m_sampleRate, Loudness::getChannelWeights (m_channelFormat));
+    m_meterBank.setSampleRate (m_sampleRate);
+}
 //==============================================================================
 
-void MetersComponent::setInputLevel (int channel, float value)
+void MetersComponent::setClock (const Clock* clock)
 {
-    if (auto* meterChannel = getMeterChannel (channel))
-        if (meterChannel)
-            meterChannel->setInputLevel (value);
+    m_clock = clock;
+
+    m_meterBank.setClock (m_clock);
+    m_labelStrip.setClock (m_clock);
+    m_loudnessMeter.setClock (m_clock);
+}
+//==============================================================================
+
+void MetersComponent::resetLoudness()
+{
+    m_loudness.reset();
+    m_loudnessMeter.reset();
+    m_loudnessMeter.resetPeakHold();
 }
 //==============================================================================
 
 void MetersComponent::createMeters (const juce::AudioChannelSet& channelFormat, const std::vector<juce::String>& channelNames)
 {
+    m_meterBank.setNumChannels (channelFormat.size());
+    configureMeterBank();
+
     // Create enough meters to match the channel format...
     for (int channelIdx = 0; channelIdx < channelFormat.size(); ++channelIdx)
     {
-        auto meterChannel = std::make_unique<MeterChannel> (m_meterOptions, Padding (0, 0, 0, 0), "meters_panel", false,
-                                                            channelFormat.getTypeOfChannel (channelIdx));
+        const auto channelType  = channelFormat.getTypeOfChannel (channelIdx);
+        const auto channelName  = juce::isPositiveAndBelow (channelIdx, static_cast<int> (channelNames.size()))
+                                   ? channelNames[static_cast<size_t> (channelIdx)]
+                                   : juce::AudioChannelSet::getAbbreviatedChannelTypeName (channelType);
+        auto       meterChannel = std::make_unique<MeterChannel> (m_meterOptions, Padding (0, 0, 0, 0), channelName, false, channelType);
 
         meterChannel->addMouseListener (this, true);
+        meterChannel->setMeterBank (&m_meterBank, channelIdx);
 
-        addChildComponent (meterChannel.get());
         m_meterChannels.add (meterChannel.release());
 
         m_labelStrip.setActive (true);
         
     }
+    attachMeters();
+    m_channelFormat = channelFormat;
+    m_truePeakDetector.prepare (m_meterChannels.size());
+    m_loudness.prepare (m_sampleRate, Loudness::getChannelWeights (m_channelFormat));
     setMeterSegments (m_segmentsOptions);
 }
 //==============================================================================
 
-void MetersComponent::deleteMeters()
+void MetersComponent::setChannelFormat (const juce::AudioChannelSet& channelFormat, const std::vector<juce::String>& channelNames /*= {}*/)
 {
-    m_meterChannels.clear();
+    deleteMeters();
+    createMeters (channelFormat, channelNames);
+    resized();
+    refresh (true);
 }
 //==============================================================================
 
-MeterChannel* MetersComponent::getMeterChannel (const int meterIndex) noexcept
+void MetersComponent::setNumChannels (int numChannels, const std::vector<juce::String>& channelNames /*= {}*/)
 {
-    return (juce::isPositiveAndBelow (meterIndex, m_meterChannels.size()) ? m_meterChannels[meterIndex] : nullptr);
+    numChannels = std::max (0, numChannels);
+
+    auto channelFormat = juce::AudioChannelSet::canonicalChannelSet (numChannels);
+    if (channelFormat.size() != numChannels)
+        channelFormat = juce::AudioChannelSet::discreteChannels (numChannels);
+
+    setChannelFormat (channelFormat, channelNames);
+}
+//==============================================================================
+
+void MetersComponent::setLayoutOptions (const LayoutOptions& layoutOptions)
+{
+    m_layout.setOptions (layoutOptions);
+    resized();
+}
+//==============================================================================
+
+void MetersComponent::deleteMeters()
+{
+    m_meterChannels.clear();
 }
 //==============================================================================
 
@@ -195,14 +508,55 @@ void MetersComponent::resetPeakHold()
 void MetersComponent::setOptions (const Options& meterOptions)
 {
     m_meterOptions = meterOptions;
+
+    m_truePeakEnabled.store (meterOptions.truePeakEnabled);
+
     for (auto* meter: m_meterChannels)
     {
         if (meter)
             meter->setOptions (meterOptions);
     }
     m_labelStrip.setOptions (meterOptions);
+    showLabelStrip();
+
+    m_loudnessEnabled.store (meterOptions.loudnessEnabled);
+    m_sampleAccurate.store (meterOptions.sampleAccurateBallistics);
+    setLoudnessMeterOptions (meterOptions);
+    configureMeterBank();
 
     setRefreshRate (meterOptions.refreshRate);
+    resized();
+}
+//==============================================================================
+
+void MetersComponent::setLoudnessMeterOptions (const Options& meterOptions)
+{
+    // The momentary loudness is already integrated (over 400 ms), so show it as is, without any ballistics...
+    auto loudnessMeterOptions                     = meterOptions;
+    loudnessMeterOptions.enabled                  = meterOptions.enabled && meterOptions.loudnessEnabled;
+    loudnessMeterOptions.showClipIndicator        = false;
+    loudnessMeterOptions.ballistics               = BallisticsType::none;
+    loudnessMeterOptions.sampleAccurateBallistics = false;
+
+    const auto wasVisible = m_loudnessMeter.isVisible();
+    m_loudnessMeter.setOptions (loudnessMeterOptions);
+
+    // Showing or hiding the loudness meter changes the room left for the other meters...
+    if (m_loudnessMeter.isVisible() != wasVisible)
+        resized();
+}
+//==============================================================================
+
+void MetersComponent::configureMeterBank()
+{
+    m_meterBank.setNumProducers (m_numProducers);
+    m_meterBank.setSampleRate (m_sampleRate);
+    m_meterBank.setClock (m_clock);
+    m_meterBank.setLevelRange (Helpers::getLevelRange (m_segmentsOptions));
+    m_meterBank.setBallistics (m_meterOptions.ballistics, m_meterOptions.decayTime_ms);
+    m_meterBank.setPeakHoldTime (m_meterOptions.peakDecayTime_ms);
+    m_meterBank.setPeakFallRate (m_meterOptions.peakFallRate);
+    m_meterBank.setSampleAccurate (m_meterOptions.sampleAccurateBallistics);
 }
 //==============================================================================
 
@@ -220,7 +574,9 @@ void MetersComponent::enable (bool enabled /*= true*/)
     }
 
     m_labelStrip.setEnabled (enabled);
-    m_labelStrip.setVisible (enabled);
+    showLabelStrip();
+
+    setLoudnessMeterOptions (m_meterOptions);
 
     refresh (true);
 }
@@ -228,6 +584,7 @@ void MetersComponent::enable (bool enabled /*= true*/)
 void MetersComponent::setMeterSegments (const std::vector<SegmentOptions>& segmentsOptions)
 {
     m_segmentsOptions = segmentsOptions;
+    m_meterBank.setLevelRange (Helpers::getLevelRange (m_segmentsOptions));
     for (auto* meter: m_meterChannels)
         if (meter)
             meter->setMeterSegments (m_segmentsOptions);
@@ -34,6 +34,7 @@
 
 #include "sd_MeterChannel.h"
 #include "sd_MeterHelpers.h"
+#include "sd_MeterLayout.h"
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
@@ -61,10 +62,17 @@ class MetersComponent final
 {
 public:
     /**
-     * @brief Default constructor.
+     * @brief Default constructor (with a stereo channel format).
     */
     MetersComponent();
 
+    /**
+     * @brief Constructor with a channel format.
+     *
+     * @param channelFormat The channel format, determining the number (and names) of the meters.
+    */
+    explicit MetersComponent (const juce::AudioChannelSet& channelFormat);
+
     /** @brief Destructor.*/
     ~MetersComponent() override;
 
@@ -72,6 +80,7 @@ public:
      * @brief Refresh (redraw) the meters panel.
      *
      * This can be called manually or internally (see useInternalTiming).
+     * The loudness is also updated while the panel is hidden, so keep refreshing it to keep the integrated loudness complete.
      *
      * @param forceRefresh When set to true, always redraw the meters panel (not only if it's dirty/changed).
      *
@@ -97,7 +106,7 @@ public:
     void resetMeters();
 
     /**
-     * @brief Clear the level of the meters.
+     * @brief Clear the level of the meters (but not the peak hold).
     */
     void clearMeters();
 
@@ -114,10 +123,168 @@ public:
      * This supplies a meter of a specific channel with the peak level from the audio engine.
      * Beware: this will usually be called from the audio thread.
      *
-     * @param channel The channel to set the input level of.
-     * @param value   The input level to set to the specified channel.
+     * @param channel  The channel to set the input level of.
+     * @param value    The input level to set to the specified channel.
+     * @param producer The index of the producer (thread) setting the level.
+     *
+     * @see setNumProducers
+    */
+    void setInputLevel (int channel, float value, int producer = 0);
+
+    /**
+     * @brief Set the input levels of all meters from an audio buffer.
+     *
+     * The peak of every channel in the buffer is calculated and supplied to the meter of the same channel,
+     * all in one pass. Channels in the buffer without a matching meter are ignored.
+     * When true-peak metering is enabled (see Options::truePeakEnabled) the true-peak level is measured instead.
+     * When the loudness meter is enabled (see Options::loudnessEnabled) the buffer is also fed to the loudness engine.
+     * The true-peak detector and loudness engine keep filter state per channel, so consecutive blocks of the same stream
+     * should be supplied and every channel should be fed by one producer only.
+     * Beware: this will usually be called from the audio thread.
+     *
+     * @param buffer   The audio buffer to get the peak levels from.
+     * @param producer The index of the producer (thread) setting the levels.
+     *
+     * @see setInputLevel, setNumProducers
+    */
+    void setInputBuffer (const juce::AudioBuffer<float>& buffer, int producer = 0);
+
+    /**
+     * @brief Set the input levels of all meters from a block of audio.
+     *
+     * @param channelData Pointers to the samples of each channel.
+     * @param numChannels The number of channels in the block.
+     * @param numSamples  The number of samples (per channel) in the block.
+     * @param producer    The index of the producer (thread) setting the levels.
+     *
+     * @see setInputLevel, setNumProducers
+    */
+    void setInputBuffer (const float* const* channelData, int numChannels, int numSamples, int producer = 0);
+
+    /**
+     * @brief Set the channel format, creating a meter for every channel.
+     *
+     * Any channel format is supported, from mono up to immersive formats (like 7.1.4) and large discrete formats (like 128 channel MADI).
+     * Beware: never call this while the audio engine is setting levels!
+     *
+     * @param channelFormat The channel format.
+     * @param channelNames  The names of the channels (optional). Channels without a name are named after their channel type.
+     *
+     * @see setNumChannels, getChannelFormat, setLayoutOptions
+    */
+    void setChannelFormat (const juce::AudioChannelSet& channelFormat, const std::vector<juce::String>& channelNames = {});
+
+    /**
+     * @brief Set the number of channels, creating a meter for every channel.
+     *
+     * Uses the canonical channel format for the number of channels (mono, stereo, etc...), or discrete channels when there is none.
+     * Beware: never call this while the audio engine is setting levels!
+     *
+     * @param numChannels  The number of channels.
+     * @param channelNames The names of the channels (optional).
+     *
+     * @see setChannelFormat
+    */
+    void setNumChannels (int numChannels, const std::vector<juce::String>& channelNames = {});
+
+    /**
+     * @brief Get the channel format.
+     * @return The channel format, one meter per channel.
+    */
+    [[nodiscard]] const juce::AudioChannelSet& getChannelFormat() const noexcept { return m_channelFormat; }
+
+    /**
+     * @brief Set the layout options of the meters.
+     *
+     * Sets the minimum meter width, the gaps between meters and between groups of meters and the width of the label strip.
+     *
+     * @param layoutOptions The layout options to use.
+     * @see setChannelFormat, setLabelStripPosition
+    */
+    void setLayoutOptions (const LayoutOptions& layoutOptions);
+
+    /**
+     * @brief Get the layout options of the meters.
+     * @return The layout options.
+    */
+    [[nodiscard]] const LayoutOptions& getLayoutOptions() const noexcept { return m_layout.getOptions(); }
+
+    /**
+     * @brief Set the number of producers (threads) feeding the meters.
+     *
+     * When the audio graph is processed on multiple threads, each thread can feed the meters
+     * with it's own producer index. The levels of all producers are merged when the meters refresh.
+     * Beware: never call this while the audio engine is setting levels!
+     *
+     * @param numProducers The number of producers.
+     *
+     * @see setInputLevel, setInputBuffer
+    */
+    void setNumProducers (int numProducers);
+
+    /**
+     * @brief Get the bank holding the levels of all meters.
+     *
+     * All channel meters are views on this bank, which is refreshed once per refresh of the panel.
+     *
+     * @return The meter bank.
+    */
+    [[nodiscard]] const MeterBank& getMeterBank() const noexcept { return m_meterBank; }
+
+    /**
+     * @brief Set the sample rate of the audio supplied to the meters.
+     *
+     * Needed for the loudness meter and sample accurate ballistics.
+     * Beware: never call this while the audio engine is setting levels!
+     *
+     * @param sampleRate The sample rate (in Hz).
+     *
+     * @see setInputBuffer
     */
-    void setInputLevel (int channel, float value);
+    void setSampleRate (double sampleRate);
+
+    /**
+     * @brief Get the momentary loudness (400 ms window).
+     *
+     * @return The momentary loudness (in LUFS).
+     * @see getShortTermLoudness, getIntegratedLoudness, resetLoudness
+    */
+    [[nodiscard]] float getMomentaryLoudness() const noexcept { return m_loudness.getMomentaryLoudness(); }
+
+    /**
+     * @brief Get the short-term loudness (3 s window).
+     *
+     * @return The short-term loudness (in LUFS).
+     * @see getMomentaryLoudness, getIntegratedLoudness, resetLoudness
+    */
+    [[nodiscard]] float getShortTermLoudness() const noexcept { return m_loudness.getShortTermLoudness(); }
+
+    /**
+     * @brief Get the integrated loudness since the last reset.
+     *
+     * @return The integrated loudness (in LUFS).
+     * @see getMomentaryLoudness, getShortTermLoudness, resetLoudness
+    */
+    [[nodiscard]] float getIntegratedLoudness() const noexcept { return m_loudness.getIntegratedLoudness(); }
+
+    /**
+     * @brief Reset the loudness measurement (including the integrated loudness).
+     *
+     * @see getIntegratedLoudness
+    */
+    void resetLoudness();
+
+    /**
+     * @brief Set the clock used to time the ballistics and the peak hold of all meters.
+     *
+     * Use a ManualClock for deterministic or faster than real-time metering.
+     * The clock is not owned by the meters and should outlive them.
+     *
+     * @param clock The clock to use, or nullptr to use the default (high resolution, real-time) clock.
+     *
+     * @see Clock, ManualClock
+    */
+    void setClock (const Clock* clock);
 
     /**
      * @brief Set meter options defining appearance and functionality.
@@ -149,6 +316,77 @@ public:
     */
     void setMeterSegments (const std::vector<SegmentOptions>& segmentsOptions);
 
+    /**
+     * @brief Set how the meters are rendered.
+     *
+     * With RenderMode::singleComponent the panel draws all meters itself, in a single paint and into one backing image,
+     * repainting a few merged dirty regions per refresh (see setMaxRepaintRegions). This avoids the overhead of a component per meter
+     * (repaint bookkeeping, image caches and hit testing) when showing many meters.
+     *
+     * @param renderMode The render mode to use.
+    */
+    void setRenderMode (RenderMode renderMode);
+
+    /**
+     * @brief Get how the meters are rendered.
+     * @return The render mode.
+    */
+    [[nodiscard]] RenderMode getRenderMode() const noexcept { return m_renderMode; }
+
+    /**
+     * @brief Set how the meter bars are rasterized.
+     *
+     * Only used with RenderMode::singleComponent. With Rasterizer::bitmap the panel renders into a software image of it's own
+     * and the bars are written straight into it's pixels, bypassing the juce software renderer for the bulk of the pixels.
+     * Rasterizer::bitmapScalar produces exactly the same pixels without SIMD, to compare the output with.
+     *
+     * @param rasterizer The rasterizer to use.
+     * @see setRenderMode
+    */
+    void setRasterizer (Rasterizer rasterizer);
+
+    /**
+     * @brief Get how the meter bars are rasterized.
+     * @return The rasterizer.
+    */
+    [[nodiscard]] Rasterizer getRasterizer() const noexcept { return m_rasterizer; }
+
+    /**
+     * @brief Set the maximum number of regions the panel repaints per refresh.
+     *
+     * The dirty parts of all meters are gathered and merged into this many regions, which the panel repaints itself.
+     * This replaces a repaint (and invalidated region) per meter with a few per refresh (Constants::kDefaultMaxRepaintRegions is a good start).
+     * The meters then have no image cache of their own (see juce::Component::setBufferedToImage), since they are repainted by the panel.
+     *
+     * By default (0) every meter repaints itself, from it's own image cache.
+     * With RenderMode::singleComponent the panel always repaints the meters, in Constants::kDefaultMaxRepaintRegions regions when this is 0.
+     *
+     * @param maxRegions The maximum number of regions to repaint per refresh, or 0 to repaint per meter.
+     * @see refresh, setRenderMode
+    */
+    void setMaxRepaintRegions (int maxRegions);
+
+    /**
+     * @brief Get the maximum number of regions the panel repaints per refresh.
+     * @return The maximum number of regions, or 0 when every meter repaints itself.
+    */
+    [[nodiscard]] int getMaxRepaintRegions() const noexcept { return m_maxRepaintRegions; }
+
+    /**
+     * @brief Set the position of the label strip.
+     *
+     * The label strip gets a column of it's own, so it's never overlapped by a meter.
+     *
+     * @param labelStripPosition The position of the label strip, or LabelStripPosition::none to hide it.
+    */
+    void setLabelStripPosition (LabelStripPosition labelStripPosition);
+
+    /**
+     * @brief Get the position of the label strip.
+     * @return The position of the label strip.
+    */
+    [[nodiscard]] LabelStripPosition getLabelStripPosition() const noexcept { return m_labelStripPosition; }
+
     /**
      * @brief Enable or disable the panel.
      *
@@ -160,6 +398,7 @@ public:
     /** @internal */
     void paint (juce::Graphics& g) override;
     void resized() override;
+    void mouseDown (const juce::MouseEvent& event) override;
 
 private:
     // clang-format off
@@ -167,11 +406,30 @@ private:
    Options                          m_meterOptions          {};  
    std::vector<SegmentOptions>      m_segmentsOptions       = MeterScales::getDefaultScale();
 
+   MeterBank                        m_meterBank             {};
    using                            MetersType              = juce::OwnedArray<MeterChannel>;
    MetersType                       m_meterChannels         {};
    MeterChannel                     m_labelStrip            {};
-
+   MeterChannel                     m_loudnessMeter         {};
+   juce::AudioChannelSet            m_channelFormat         {};
+
+   TruePeakDetector                 m_truePeakDetector      {};
+   std::atomic<bool>                m_truePeakEnabled       { false };
+   Loudness                         m_loudness              {};
+   std::atomic<bool>                m_loudnessEnabled       { false };
+   std::atomic<bool>                m_sampleAccurate        { false };
+   double                           m_sampleRate            = 48000.0;
+   const Clock*                     m_clock                 = nullptr;
+
+   RenderMode                       m_renderMode            = RenderMode::components;
+   Rasterizer                       m_rasterizer            = Rasterizer::graphics;
+   LabelStripPosition               m_labelStripPosition    = LabelStripPosition::center;
+   MeterLayout                      m_layout                {};
+   juce::Image                      m_backingImage          {};  // Software image the bitmap rasterizers render into.
+   int                              m_maxRepaintRegions     = 0;
+   std::vector<juce::Rectangle<int>> m_dirtyRegions         {};  // Dirty parts of the meters, gathered during a refresh.
    bool                             m_useInternalTimer      = true;
+   int                              m_numProducers          = 1;
    juce::FontOptions                m_font;
 
 
@@ -180,7 +438,14 @@ private:
 //   void                             setColours              ();
    void                             createMeters            (const juce::AudioChannelSet& channelFormat, const std::vector<juce::String>& channelNames);
    void                             deleteMeters            ();
-   [[nodiscard]] MeterChannel*      getMeterChannel         (int meterIndex) noexcept;     
+   void                             setLoudnessMeterOptions (const Options& meterOptions);
+   void                             configureMeterBank      ();
+   void                             attachMeters            ();
+   void                             showLabelStrip          ();
+   void                             refreshMeter            (MeterChannel& meter, bool forceRefresh);
+   [[nodiscard]] bool               isCoalescingRepaints    () const noexcept { return m_renderMode == RenderMode::singleComponent || m_maxRepaintRegions > 0; }
+   void                             paintBitmap             (juce::Graphics& g);
+   void                             drawMeters              (juce::Graphics& g, juce::Image::BitmapData* bitmap, float scale) const;
 
 
     // clang-format on
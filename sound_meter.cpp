@@ -45,7 +45,10 @@
 #include "sound_meter.h"
 
 #include "meter/sd_MeterHelpers.cpp"
+#include "meter/sd_MeterGlyphAtlas.cpp"
+#include "meter/sd_MeterBitmapFill.cpp"
 #include "meter/sd_MeterSegment.cpp"
 #include "meter/sd_MeterLevel.cpp"
 #include "meter/sd_MeterChannel.cpp"
+#include "meter/sd_MeterLayout.cpp"
 #include "meter/sd_MetersComponent.cpp"
@@ -47,7 +47,7 @@ BEGIN_JUCE_MODULE_DECLARATION
     website:            https://www.sounddevelopment.nl
     license:            MIT   
     minimumCppStandard: 14
-    dependencies:       juce_audio_basics, juce_gui_basics, juce_events, juce_graphics
+    dependencies:       sound_meter_core, juce_audio_basics, juce_gui_basics, juce_events, juce_graphics
 END_JUCE_MODULE_DECLARATION
 
 #endif
@@ -74,9 +74,13 @@ END_JUCE_MODULE_DECLARATION
 #include <juce_events/juce_events.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_graphics/juce_graphics.h>
+#include <sound_meter_core/sound_meter_core.h>
 
 #include "meter/sd_MeterHelpers.h"
+#include "meter/sd_MeterGlyphAtlas.h"
+#include "meter/sd_MeterBitmapFill.h"
 #include "meter/sd_MeterSegment.h"
 #include "meter/sd_MeterLevel.h"
 #include "meter/sd_MeterChannel.h"
+#include "meter/sd_MeterLayout.h"
 #include "meter/sd_MetersComponent.h"
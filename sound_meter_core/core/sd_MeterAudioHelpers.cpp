@@ -0,0 +1,62 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterAudioHelpers.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+namespace Helpers
+{
+float getPeakLevel (const float* samples, int numSamples) noexcept
+{
+    if (samples == nullptr || numSamples <= 0)
+        return 0.0f;
+
+    const auto minMax = juce::FloatVectorOperations::findMinAndMax (samples, numSamples);
+    return std::max (-minMax.getStart(), minMax.getEnd());
+}
+//==============================================================================
+
+void atomicMax (std::atomic<float>& value, float newValue) noexcept
+{
+    auto current = value.load (std::memory_order_relaxed);
+    while (newValue > current && !value.compare_exchange_weak (current, newValue, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+//==============================================================================
+
+}  // namespace Helpers
+}  // namespace SoundMeter
+}  // namespace sd
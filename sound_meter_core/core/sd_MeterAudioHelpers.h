@@ -0,0 +1,67 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+namespace Helpers
+{
+/**
+ * @brief Get the absolute peak of a block of samples.
+ *
+ * Uses juce's vectorised min/max reduction, so the block is scanned only once.
+ *
+ * @param samples    The samples to scan.
+ * @param numSamples The number of samples to scan.
+ * @return The absolute peak level (in amp).
+*/
+[[nodiscard]] float getPeakLevel (const float* samples, int numSamples) noexcept;
+
+/**
+ * @brief Atomically raise a value to a new maximum.
+ *
+ * Lock-free fetch-max. When the new value is not larger, this is a single atomic load.
+ * Otherwise a compare-exchange is used, which only retries when another thread raised the value in between.
+ *
+ * @param value    The atomic to raise.
+ * @param newValue The candidate maximum.
+*/
+void atomicMax (std::atomic<float>& value, float newValue) noexcept;
+}  // namespace Helpers
+}  // namespace SoundMeter
+}  // namespace sd
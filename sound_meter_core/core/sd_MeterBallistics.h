@@ -0,0 +1,194 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include "sd_MeterDecibels.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/** @brief Type of meter ballistics (the way the meter responds to level changes). */
+enum class BallisticsType
+{
+    linear,       ///< Instant attack, linear (dB) release over the decay time.
+    exponential,  ///< Instant attack, exponential (dB) release settling within the decay time.
+    vu,           ///< VU meter. 300 ms integration time (99% of the level reached after 300 ms), both attack and release.
+    ppmType1,     ///< IEC 60268-10 Type I PPM (DIN). 10 ms integration time, 20 dB return in 1.5 s.
+    ppmType2,     ///< IEC 60268-10 Type II PPM (BBC/EBU). 10 ms integration time, 24 dB return in 2.8 s.
+    ppmNordic,    ///< IEC 60268-10 Type I PPM (Nordic). 5 ms integration time, 20 dB return in 1.7 s.
+    none          ///< No ballistics. The meter follows the input level at once (e.g. for levels which are already integrated, like loudness).
+};
+
+/**
+ * @brief Meter ballistics policies.
+ *
+ * Every policy has a static 'prepare' function, calculating the coefficients once when the meter is configured,
+ * and a static, branch-free 'process' function, calculating the next meter level.
+ * Policies can be used directly as template arguments, or selected at runtime with 'visit'.
+*/
+namespace Ballistics
+{
+/** @brief Pre-calculated ballistics coefficients. The meaning depends on the policy. */
+struct Coefficients
+{
+    float attack  = 0.0f;  ///< Attack coefficient.
+    float release = 0.0f;  ///< Release coefficient.
+};
+
+/** @brief Get the coefficient (-1 / time constant) of a one-pole integrator reaching a fraction of it's target within a time. */
+[[nodiscard]] inline float getTimeConstantCoefficient (float time_ms, float fractionReached) noexcept
+{
+    return std::log (1.0f - fractionReached) / std::max (time_ms, 1.0e-3f);
+}
+
+/** @brief Move a level (in decibels) towards a target in the amplitude domain, with a one-pole integrator. */
+[[nodiscard]] inline float integrate (float level_db, float target_db, float coefficient, float elapsed_ms) noexcept
+{
+    const auto level  = juce::Decibels::decibelsToGain (level_db);
+    const auto target = juce::Decibels::decibelsToGain (target_db);
+    return Decibels::gainToDecibels (level + (target - level) * (1.0f - std::exp (coefficient * elapsed_ms)));
+}
+
+/** @brief No ballistics. Instant attack and release. */
+struct None
+{
+    [[nodiscard]] static Coefficients prepare (float /*decayTime_ms*/, float /*range_db*/) noexcept { return {}; }
+    [[nodiscard]] static float        process (Coefficients /*coefficients*/, float /*level_db*/, float input_db, float /*elapsed_ms*/) noexcept { return input_db; }
+};
+
+/** @brief Instant attack, linear release (in dB/ms). */
+struct Linear
+{
+    [[nodiscard]] static Coefficients prepare (float decayTime_ms, float range_db) noexcept { return { 0.0f, range_db / decayTime_ms }; }
+    [[nodiscard]] static float        process (Coefficients coefficients, float level_db, float input_db, float elapsed_ms) noexcept
+    {
+        return std::max (input_db, level_db - elapsed_ms * coefficients.release);
+    }
+};
+
+/** @brief Instant attack, exponential release (in dB), settling within 1% after the decay time. */
+struct Exponential
+{
+    [[nodiscard]] static Coefficients prepare (float decayTime_ms, float /*range_db*/) noexcept { return { 0.0f, getTimeConstantCoefficient (decayTime_ms, 0.99f) }; }
+    [[nodiscard]] static float        process (Coefficients coefficients, float level_db, float input_db, float elapsed_ms) noexcept
+    {
+        return std::max (input_db, level_db + (input_db - level_db) * (1.0f - std::exp (coefficients.release * elapsed_ms)));
+    }
+};
+
+/** @brief VU meter. Symmetrical attack and release, reaching 99% of the level in 300 ms. */
+struct Vu
+{
+    [[nodiscard]] static Coefficients prepare (float /*decayTime_ms*/, float /*range_db*/) noexcept
+    {
+        const auto coefficient = getTimeConstantCoefficient (300.0f, 0.99f);
+        return { coefficient, coefficient };
+    }
+    [[nodiscard]] static float process (Coefficients coefficients, float level_db, float input_db, float elapsed_ms) noexcept
+    {
+        return integrate (level_db, input_db, coefficients.attack, elapsed_ms);
+    }
+};
+
+/**
+ * @brief Peak programme meter (IEC 60268-10).
+ *
+ * Integrating attack (a tone burst of the integration time reads the specified amount below the steady level),
+ * linear release (the return time is the time to fall the return range).
+*/
+template <int IntegrationTime_ms, int BurstReading_cB, int ReturnRange_db, int ReturnTime_ms>
+struct Ppm
+{
+    [[nodiscard]] static Coefficients prepare (float /*decayTime_ms*/, float /*range_db*/) noexcept
+    {
+        const auto burstReading = juce::Decibels::decibelsToGain (static_cast<float> (BurstReading_cB) / 10.0f);
+        return { getTimeConstantCoefficient (static_cast<float> (IntegrationTime_ms), burstReading),
+                 static_cast<float> (ReturnRange_db) / static_cast<float> (ReturnTime_ms) };
+    }
+    [[nodiscard]] static float process (Coefficients coefficients, float level_db, float input_db, float elapsed_ms) noexcept
+    {
+        const auto attack_db  = integrate (level_db, input_db, coefficients.attack, elapsed_ms);
+        const auto release_db = std::max (input_db, level_db - elapsed_ms * coefficients.release);
+        return input_db > level_db ? attack_db : release_db;
+    }
+};
+
+using PpmType1  = Ppm<10, -10, 20, 1500>;  ///< IEC 60268-10 Type I (DIN).
+using PpmType2  = Ppm<10, -25, 24, 2800>;  ///< IEC 60268-10 Type II (BBC/EBU).
+using PpmNordic = Ppm<5, -10, 20, 1700>;   ///< IEC 60268-10 Type I (Nordic).
+
+/**
+ * @brief Call a function with the ballistics policy matching a ballistics type.
+ *
+ * The function is called with a (default constructed) policy object, so generic lambdas
+ * get a separate, fully inlined, instantiation for every policy.
+ *
+ * @param type     The type of ballistics.
+ * @param function The function to call with the policy.
+ * @return The result of the function.
+*/
+template <typename Function>
+decltype (auto) visit (BallisticsType type, Function&& function)
+{
+    switch (type)
+    {
+        case BallisticsType::exponential: return function (Exponential {});
+        case BallisticsType::vu: return function (Vu {});
+        case BallisticsType::ppmType1: return function (PpmType1 {});
+        case BallisticsType::ppmType2: return function (PpmType2 {});
+        case BallisticsType::ppmNordic: return function (PpmNordic {});
+        case BallisticsType::none: return function (None {});
+        case BallisticsType::linear:
+        default: return function (Linear {});
+    }
+}
+
+/**
+ * @brief Calculate the coefficients of a ballistics type.
+ *
+ * @param type         The type of ballistics.
+ * @param decayTime_ms The meter decay time (in milliseconds).
+ * @param range_db     The range of the meter (in decibels).
+ * @return The pre-calculated coefficients.
+*/
+[[nodiscard]] inline Coefficients prepare (BallisticsType type, float decayTime_ms, float range_db) noexcept
+{
+    return visit (type, [=] (auto policy) { return decltype (policy)::prepare (decayTime_ms, range_db); });
+}
+}  // namespace Ballistics
+}  // namespace SoundMeter
+}  // namespace sd
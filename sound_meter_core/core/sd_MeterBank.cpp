@@ -0,0 +1,316 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterBank.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+MeterBank::MeterBank (int numChannels /*= 0*/)
+{
+    setNumChannels (numChannels);
+}
+//==============================================================================
+
+void MeterBank::setNumChannels (int numChannels)
+{
+    m_numChannels = std::max (0, numChannels);
+    allocate();
+}
+//==============================================================================
+
+void MeterBank::setNumProducers (int numProducers)
+{
+    numProducers = std::max (1, numProducers);
+    if (numProducers == m_numProducers)
+        return;
+
+    m_numProducers = numProducers;
+    allocate();
+}
+//==============================================================================
+
+void MeterBank::allocate()
+{
+    const auto numChannels = static_cast<size_t> (m_numChannels);
+
+    m_numBlocksPerProducer = (m_numChannels + AccumulatorBlock::kNumChannels - 1) / AccumulatorBlock::kNumChannels;
+    m_inputAccumulators    = std::make_unique<AccumulatorBlock[]> (static_cast<size_t> (m_numBlocksPerProducer * m_numProducers));
+
+    m_ballisticLevels = std::make_unique<std::atomic<BallisticLevels>[]> (numChannels);
+    m_audioResetFlags = std::make_unique<std::atomic<int>[]> (numChannels);
+    m_audioClipFlags  = std::make_unique<std::atomic<uint8_t>[]> (numChannels);
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        m_ballisticLevels[channel].store (BallisticLevels {}, std::memory_order_relaxed);
+        m_audioResetFlags[channel].store (0, std::memory_order_relaxed);
+        m_audioClipFlags[channel].store (0, std::memory_order_relaxed);
+    }
+
+    m_inputLevels_db.assign (numChannels, Constants::kMinLevel_db);
+    m_meterLevels_db.assign (numChannels, Constants::kMinLevel_db);
+    m_peakHoldLevels_db.assign (numChannels, Constants::kMinLevel_db);
+    m_peakHolds.assign (numChannels, PeakHold {});
+    for (auto& peakHold: m_peakHolds)
+        peakHold.reset (Constants::kMinLevel_db);
+    m_clipFlags.assign (numChannels, 0);
+
+    m_audioLevels.assign (numChannels, BallisticLevels {});
+    m_audioPeakHolds = m_peakHolds;
+    m_audioTimes_ms.assign (numChannels, 0.0);
+}
+//==============================================================================
+
+std::atomic<float>& MeterBank::getAccumulator (int producer, int channel) const noexcept
+{
+    return m_inputAccumulators[producer * m_numBlocksPerProducer + channel / AccumulatorBlock::kNumChannels].levels[channel % AccumulatorBlock::kNumChannels];
+}
+//==============================================================================
+
+void MeterBank::setBallistics (BallisticsType ballistics, float decayTime_ms)
+{
+    m_ballistics   = ballistics;
+    m_decayTime_ms = juce::jlimit (Constants::kMinDecay_ms, Constants::kMaxDecay_ms, decayTime_ms);
+    calculateCoefficients();
+}
+//==============================================================================
+
+void MeterBank::setPeakHoldTime (float peakHoldTime_ms)
+{
+    m_peakHoldTime_ms = std::max (0.0f, peakHoldTime_ms);
+    m_audioPeakHoldTime_ms.store (m_peakHoldTime_ms);
+}
+//==============================================================================
+
+void MeterBank::setPeakFallRate (float peakFallRate_dbPerSec)
+{
+    m_peakFallRate_dbPerMs = std::max (0.0f, peakFallRate_dbPerSec) / 1000.0f;
+    m_audioPeakFallRate_dbPerMs.store (m_peakFallRate_dbPerMs);
+}
+//==============================================================================
+
+void MeterBank::setLevelRange (juce::Range<float> levelRange)
+{
+    if (levelRange.isEmpty() || levelRange == m_levelRange)
+        return;
+
+    m_levelRange = levelRange;
+    calculateCoefficients();
+}
+//==============================================================================
+
+void MeterBank::setSampleRate (double sampleRate) noexcept
+{
+    if (sampleRate > 0.0)
+        m_samplePeriod_ms.store (static_cast<float> (1000.0 / sampleRate));
+}
+//==============================================================================
+
+void MeterBank::calculateCoefficients()
+{
+    m_coefficients = Ballistics::prepare (m_ballistics, m_decayTime_ms, m_levelRange.getLength());
+    m_audioCoefficients.store (m_coefficients);
+    m_audioBallistics.store (m_ballistics);
+}
+//==============================================================================
+
+void MeterBank::setInputLevel (int channel, float newLevel, int producer /*= 0*/) noexcept
+{
+    jassert (juce::isPositiveAndBelow (producer, m_numProducers));  // Producer index out of range. Set enough producers with setNumProducers.
+
+    if (!juce::isPositiveAndBelow (channel, m_numChannels))
+        return;
+
+    const auto row = juce::isPositiveAndBelow (producer, m_numProducers) ? producer : 0;
+    Helpers::atomicMax (getAccumulator (row, channel), newLevel);
+}
+//==============================================================================
+
+void MeterBank::setInputBlockLevel (int channel, float blockPeak, int numSamples) noexcept
+{
+    if (!juce::isPositiveAndBelow (channel, m_numChannels))
+        return;
+
+    auto& levels   = m_audioLevels[static_cast<size_t> (channel)];
+    auto& peakHold = m_audioPeakHolds[static_cast<size_t> (channel)];
+    auto& time_ms  = m_audioTimes_ms[static_cast<size_t> (channel)];
+
+    const auto resetFlags = m_audioResetFlags[channel].exchange (0, std::memory_order_acquire);
+    if ((resetFlags & resetLevelFlag) != 0)
+        levels.meterLevel_db = Constants::kMinLevel_db;
+    if ((resetFlags & resetPeakHoldFlag) != 0)
+    {
+        peakHold.reset (Constants::kMinLevel_db);
+    }
+
+    const auto blockDuration_ms = static_cast<float> (numSamples) * m_samplePeriod_ms.load (std::memory_order_relaxed);
+    const auto blockLevel_db    = juce::jlimit (Constants::kMinLevel_db, Constants::kMaxLevel_db, Decibels::gainToDecibels (blockPeak));
+
+    const auto coefficients = m_audioCoefficients.load (std::memory_order_relaxed);
+    levels.meterLevel_db    = Ballistics::visit (m_audioBallistics.load (std::memory_order_relaxed), [&] (auto policy) {
+        return decltype (policy)::process (coefficients, levels.meterLevel_db, blockLevel_db, blockDuration_ms);
+    });
+
+    // Peak hold (over the block maxima)...
+    time_ms += blockDuration_ms;
+    levels.peakHoldLevel_db = peakHold.process (levels.meterLevel_db, time_ms, blockDuration_ms, m_audioPeakHoldTime_ms.load (std::memory_order_relaxed),
+                                                m_audioPeakFallRate_dbPerMs.load (std::memory_order_relaxed));
+
+    // Clipping is detected on the input level, since ballistics with an integrating attack (VU, PPM) never reach full scale on short overs.
+    // The flag is latched until the GUI thread collects it, so no over in between two refreshes is lost...
+    if (blockLevel_db >= Constants::kMaxLevel_db)
+        m_audioClipFlags[channel].store (1, std::memory_order_relaxed);
+
+    m_ballisticLevels[channel].store (levels, std::memory_order_release);
+}
+//==============================================================================
+
+void MeterBank::refresh()
+{
+    const auto currentTime = m_clock->getMilliseconds();
+    const auto elapsed_ms  = static_cast<float> (currentTime - m_previousRefreshTime_ms);
+    m_previousRefreshTime_ms = currentTime;
+    m_time_ms += elapsed_ms;
+
+    if (m_sampleAccurate)
+    {
+        collectBallisticLevels();
+    }
+    else
+    {
+        collectInputLevels();
+        Ballistics::visit (m_ballistics, [&] (auto policy) { applyBallistics<decltype (policy)> (elapsed_ms); });
+        updatePeakHold (elapsed_ms);
+    }
+}
+//==============================================================================
+
+void MeterBank::collectInputLevels() noexcept
+{
+    auto* inputLevels = m_inputLevels_db.data();
+    for (int channel = 0; channel < m_numChannels; ++channel)
+    {
+        auto inputLevel = 0.0f;
+        for (int producer = 0; producer < m_numProducers; ++producer)
+            inputLevel = std::max (inputLevel, getAccumulator (producer, channel).exchange (0.0f, std::memory_order_acquire));
+
+        inputLevels[channel] = inputLevel;
+    }
+
+    // Convert all channels in one go (in-place)...
+    Decibels::gainToDecibels (inputLevels, inputLevels, m_numChannels, m_levelRange.getStart());
+
+    // Clipping is detected on the input level (before the ballistics and the level range), since ballistics
+    // with an integrating attack (VU, PPM) never reach full scale on short overs...
+    auto* clip = m_clipFlags.data();
+    for (int channel = 0; channel < m_numChannels; ++channel)
+        clip[channel] |= static_cast<uint8_t> (inputLevels[channel] >= Constants::kMaxLevel_db);
+
+    juce::FloatVectorOperations::min (inputLevels, inputLevels, m_levelRange.getEnd(), m_numChannels);
+}
+//==============================================================================
+
+void MeterBank::collectBallisticLevels() noexcept
+{
+    for (int channel = 0; channel < m_numChannels; ++channel)
+    {
+        const auto levels                                  = m_ballisticLevels[channel].load (std::memory_order_acquire);
+        m_meterLevels_db[static_cast<size_t> (channel)]    = m_levelRange.clipValue (levels.meterLevel_db);
+        m_peakHoldLevels_db[static_cast<size_t> (channel)] = m_levelRange.clipValue (levels.peakHoldLevel_db);
+        m_clipFlags[static_cast<size_t> (channel)] |= m_audioClipFlags[channel].exchange (0, std::memory_order_relaxed);
+    }
+}
+//==============================================================================
+
+template <typename Policy>
+void MeterBank::applyBallistics (float elapsed_ms) noexcept
+{
+    const auto  coefficients = m_coefficients;
+    const auto  minLevel_db  = m_levelRange.getStart();
+    const auto  maxLevel_db  = m_levelRange.getEnd();
+    const auto* input_db     = m_inputLevels_db.data();
+    auto*       level_db     = m_meterLevels_db.data();
+
+    for (int channel = 0; channel < m_numChannels; ++channel)
+        level_db[channel] = std::clamp (Policy::process (coefficients, level_db[channel], input_db[channel], elapsed_ms), minLevel_db, maxLevel_db);
+}
+//==============================================================================
+
+void MeterBank::updatePeakHold (float elapsed_ms) noexcept
+{
+    const auto* level_db    = m_meterLevels_db.data();
+    auto*       peakHold_db = m_peakHoldLevels_db.data();
+    auto*       peakHolds   = m_peakHolds.data();
+
+    for (int channel = 0; channel < m_numChannels; ++channel)
+        peakHold_db[channel] = peakHolds[channel].process (level_db[channel], m_time_ms, elapsed_ms, m_peakHoldTime_ms, m_peakFallRate_dbPerMs);
+}
+//==============================================================================
+
+void MeterBank::reset (int channel) noexcept
+{
+    if (!juce::isPositiveAndBelow (channel, m_numChannels))
+        return;
+
+    for (int producer = 0; producer < m_numProducers; ++producer)
+        getAccumulator (producer, channel).store (0.0f);
+
+    m_inputLevels_db[static_cast<size_t> (channel)] = Constants::kMinLevel_db;
+    m_meterLevels_db[static_cast<size_t> (channel)] = Constants::kMinLevel_db;
+    m_audioResetFlags[channel].fetch_or (resetLevelFlag, std::memory_order_release);
+}
+//==============================================================================
+
+void MeterBank::resetPeakHold (int channel) noexcept
+{
+    if (!juce::isPositiveAndBelow (channel, m_numChannels))
+        return;
+
+    m_peakHoldLevels_db[static_cast<size_t> (channel)] = Constants::kMinLevel_db;
+    m_peakHolds[static_cast<size_t> (channel)].reset (Constants::kMinLevel_db);
+    m_audioResetFlags[channel].fetch_or (resetPeakHoldFlag, std::memory_order_release);
+}
+//==============================================================================
+
+void MeterBank::resetClip (int channel) noexcept
+{
+    if (!juce::isPositiveAndBelow (channel, m_numChannels))
+        return;
+
+    m_clipFlags[static_cast<size_t> (channel)] = 0;
+    m_audioClipFlags[channel].store (0, std::memory_order_relaxed);
+}
+//==============================================================================
+
+}  // namespace SoundMeter
+}  // namespace sd
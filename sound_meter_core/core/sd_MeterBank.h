@@ -0,0 +1,330 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include "sd_MeterAudioHelpers.h"
+#include "sd_MeterBallistics.h"
+#include "sd_MeterClock.h"
+#include "sd_MeterConstants.h"
+#include "sd_MeterDecibels.h"
+#include "sd_MeterPeakHold.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief The metering state of a whole bank of channels.
+ *
+ * Input levels, meter levels, peak hold levels, peak hold timers and clip flags of all channels
+ * are stored in contiguous arrays (struct-of-arrays), so the whole bank is refreshed in one (vectorisable) pass.
+ * The meters (the GUI components) only read from the bank.
+ *
+ * The audio thread feeds the bank with setInputLevel (or setInputBlockLevel with sample accurate ballistics).
+ * The GUI thread calls refresh, before reading the levels.
+*/
+class MeterBank final
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param numChannels The number of channels in the bank.
+    */
+    explicit MeterBank (int numChannels = 0);
+
+    /**
+     * @brief Set the number of channels in the bank.
+     *
+     * This also resets all levels.
+     * Beware: this allocates, so never call this while the audio engine is setting levels!
+     *
+     * @param numChannels The number of channels.
+    */
+    void setNumChannels (int numChannels);
+
+    /**
+     * @brief Get the number of channels in the bank.
+     * @return The number of channels.
+    */
+    [[nodiscard]] int getNumChannels() const noexcept { return m_numChannels; }
+
+    /**
+     * @brief Set the number of producers (threads) feeding the bank.
+     *
+     * Every producer gets it's own row of accumulators (padded to whole cache lines), which are merged on refresh.
+     * Beware: this allocates, so never call this while the audio engine is setting levels!
+     *
+     * @param numProducers The number of producers.
+    */
+    void setNumProducers (int numProducers);
+
+    /**
+     * @brief Get the number of producers (threads) feeding the bank.
+     * @return The number of producers.
+    */
+    [[nodiscard]] int getNumProducers() const noexcept { return m_numProducers; }
+
+    /**
+     * @brief Set the ballistics of the meters.
+     *
+     * @param ballistics   The type of ballistics.
+     * @param decayTime_ms The meter decay time (in milliseconds).
+    */
+    void setBallistics (BallisticsType ballistics, float decayTime_ms);
+
+    /**
+     * @brief Set the peak hold time.
+     *
+     * The peak hold shows the maximum level of the last 'peak hold time' milliseconds.
+     *
+     * @param peakHoldTime_ms The length of the peak hold window (in milliseconds).
+    */
+    void setPeakHoldTime (float peakHoldTime_ms);
+
+    /**
+     * @brief Set the rate at which the peak hold falls back, when it's maximum leaves the window.
+     *
+     * @param peakFallRate_dbPerSec The fall back rate (in decibels per second), or 0 to fall back at once.
+    */
+    void setPeakFallRate (float peakFallRate_dbPerSec);
+
+    /**
+     * @brief Set the range of levels displayed by the meters.
+     *
+     * @param levelRange The level range (in decibels).
+    */
+    void setLevelRange (juce::Range<float> levelRange);
+
+    /**
+     * @brief Get the range of levels displayed by the meters.
+     * @return The level range (in decibels).
+    */
+    [[nodiscard]] juce::Range<float> getLevelRange() const noexcept { return m_levelRange; }
+
+    /**
+     * @brief Enable or disable sample accurate ballistics.
+     *
+     * With sample accurate ballistics, the ballistics are calculated by the audio thread (see setInputBlockLevel).
+     *
+     * @param sampleAccurate When set to true, the ballistics are calculated on the audio thread.
+    */
+    void setSampleAccurate (bool sampleAccurate) noexcept { m_sampleAccurate = sampleAccurate; }
+
+    /**
+     * @brief Set the sample rate of the audio feeding the bank.
+     *
+     * Used with sample accurate ballistics.
+     *
+     * @param sampleRate The sample rate (in Hz).
+    */
+    void setSampleRate (double sampleRate) noexcept;
+
+    /**
+     * @brief Set the clock used to time the ballistics and the peak hold.
+     *
+     * The clock is not owned by the bank and should outlive it.
+     *
+     * @param clock The clock to use, or nullptr to use the default (high resolution, real-time) clock.
+    */
+    void setClock (const Clock* clock) noexcept { m_clock = clock != nullptr ? clock : &Clock::getDefault(); }
+
+    /**
+     * @brief Set the input level of a channel.
+     *
+     * The level is accumulated (the maximum is kept) until the bank is refreshed.
+     * Beware: called from the audio thread! Channels outside the bank are ignored.
+     *
+     * @param channel  The channel to set the level of.
+     * @param newLevel The peak level from the audio engine (in amp).
+     * @param producer The index of the producer (thread) setting the level.
+    */
+    void setInputLevel (int channel, float newLevel, int producer = 0) noexcept;
+
+    /**
+     * @brief Set the level of a block of audio of a channel and calculate the ballistics.
+     *
+     * Used with sample accurate ballistics.
+     * The decay and peak hold are integrated over the duration of the block (based on the sample rate).
+     * Beware: called from the audio thread! Only one thread should feed a channel this way.
+     *
+     * @param channel    The channel to set the level of.
+     * @param blockPeak  The peak level of the block (in amp).
+     * @param numSamples The number of samples in the block.
+    */
+    void setInputBlockLevel (int channel, float blockPeak, int numSamples) noexcept;
+
+    /**
+     * @brief Refresh all meter levels, peak hold levels and clip flags.
+     *
+     * Called from the GUI thread.
+    */
+    void refresh();
+
+    /**
+     * @brief Reset the levels of a channel (but not the peak hold).
+     * @param channel The channel to reset.
+    */
+    void reset (int channel) noexcept;
+
+    /**
+     * @brief Reset the peak hold of a channel.
+     * @param channel The channel to reset the peak hold of.
+    */
+    void resetPeakHold (int channel) noexcept;
+
+    /**
+     * @brief Reset the clip indicator of a channel.
+     * @param channel The channel to reset the clip indicator of.
+    */
+    void resetClip (int channel) noexcept;
+
+    /**
+     * @brief Get the input level of a channel at the last refresh.
+     * @param channel The channel.
+     * @return The input level (in decibels).
+    */
+    [[nodiscard]] float getInputLevel (int channel) const noexcept { return m_inputLevels_db[static_cast<size_t> (channel)]; }
+
+    /**
+     * @brief Get the meter level (including ballistics) of a channel.
+     * @param channel The channel.
+     * @return The meter level (in decibels).
+    */
+    [[nodiscard]] float getMeterLevel (int channel) const noexcept { return m_meterLevels_db[static_cast<size_t> (channel)]; }
+
+    /**
+     * @brief Get the peak hold level of a channel.
+     * @param channel The channel.
+     * @return The peak hold level (in decibels).
+    */
+    [[nodiscard]] float getPeakHoldLevel (int channel) const noexcept { return m_peakHoldLevels_db[static_cast<size_t> (channel)]; }
+
+    /**
+     * @brief Check if a channel has clipped (since the last clip reset).
+     *
+     * A channel clips when an input level reaches full scale. This is checked before the ballistics,
+     * so also short overs clip with an integrating attack (VU, PPM). The peak hold is for display only.
+     * @param channel The channel.
+     * @return True, if the channel has clipped.
+    */
+    [[nodiscard]] bool isClipping (int channel) const noexcept { return m_clipFlags[static_cast<size_t> (channel)] != 0; }
+
+    /** @brief Get the meter levels (in decibels) of all channels. */
+    [[nodiscard]] const float* getMeterLevels() const noexcept { return m_meterLevels_db.data(); }
+
+    /** @brief Get the peak hold levels (in decibels) of all channels. */
+    [[nodiscard]] const float* getPeakHoldLevels() const noexcept { return m_peakHoldLevels_db.data(); }
+
+    /** @brief Get the clip flags (non-zero when clipped) of all channels. */
+    [[nodiscard]] const uint8_t* getClipFlags() const noexcept { return m_clipFlags.data(); }
+
+private:
+    // Meter and peak hold level, published by the audio thread in one go (sample accurate ballistics).
+    struct BallisticLevels
+    {
+        float meterLevel_db    = Constants::kMinLevel_db;
+        float peakHoldLevel_db = Constants::kMinLevel_db;
+    };
+
+    enum AudioResetFlags
+    {
+        resetLevelFlag    = 1,
+        resetPeakHoldFlag = 2
+    };
+
+    // Accumulated input levels (in amp) of a cache line worth of channels.
+    struct alignas (64) AccumulatorBlock
+    {
+        static constexpr int kNumChannels = 16;
+        std::atomic<float>   levels[kNumChannels] {};
+    };
+
+    int m_numChannels          = 0;
+    int m_numProducers         = 1;
+    int m_numBlocksPerProducer = 0;
+
+    // Audio thread to GUI thread...
+    std::unique_ptr<AccumulatorBlock[]>             m_inputAccumulators {};  // A row of blocks per producer, so producers never share a cache line.
+    std::unique_ptr<std::atomic<BallisticLevels>[]> m_ballisticLevels {};
+    std::unique_ptr<std::atomic<int>[]>             m_audioResetFlags {};
+    std::unique_ptr<std::atomic<uint8_t>[]>         m_audioClipFlags {};  // Set by the audio thread (sample accurate ballistics), next to the published levels.
+
+    // GUI thread state...
+    std::vector<float>   m_inputLevels_db {};
+    std::vector<float>   m_meterLevels_db {};
+    std::vector<float>   m_peakHoldLevels_db {};
+    std::vector<PeakHold> m_peakHolds {};
+    std::vector<uint8_t> m_clipFlags {};
+
+    // Audio thread state (sample accurate ballistics)...
+    std::vector<BallisticLevels> m_audioLevels {};
+    std::vector<PeakHold>        m_audioPeakHolds {};
+    std::vector<double>          m_audioTimes_ms {};  // Duration of the audio fed to every channel.
+
+    // Configuration...
+    BallisticsType           m_ballistics      = BallisticsType::linear;
+    float                    m_decayTime_ms    = Constants::kDefaultDecay_ms;
+    Ballistics::Coefficients m_coefficients {};
+    float                    m_peakHoldTime_ms = Constants::kPeakDefaultDecay_ms;
+    float                    m_peakFallRate_dbPerMs = 0.0f;
+    juce::Range<float>       m_levelRange { Constants::kMinLevel_db, Constants::kMaxLevel_db };
+    bool                     m_sampleAccurate  = false;
+    const Clock*             m_clock           = &Clock::getDefault();
+    double                   m_previousRefreshTime_ms = 0.0;
+    double                   m_time_ms                = 0.0;  // Time passed in refreshes.
+
+    // Configuration mirrored for the audio thread...
+    std::atomic<BallisticsType>           m_audioBallistics { BallisticsType::linear };
+    std::atomic<Ballistics::Coefficients> m_audioCoefficients { Ballistics::Coefficients {} };
+    std::atomic<float>                    m_audioPeakHoldTime_ms { Constants::kPeakDefaultDecay_ms };
+    std::atomic<float>                    m_audioPeakFallRate_dbPerMs { 0.0f };
+    std::atomic<float>                    m_samplePeriod_ms { 1000.0f / 48000.0f };
+
+    void allocate();
+    [[nodiscard]] std::atomic<float>& getAccumulator (int producer, int channel) const noexcept;
+    void collectInputLevels() noexcept;
+    void collectBallisticLevels() noexcept;
+    void updatePeakHold (float elapsed_ms) noexcept;
+    void calculateCoefficients();
+
+    template <typename Policy>
+    void applyBallistics (float elapsed_ms) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeterBank)
+};
+}  // namespace SoundMeter
+}  // namespace sd
@@ -0,0 +1,107 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief Time source for the meter ballistics and peak hold timing.
+ *
+ * By default the meters use a high resolution real-time clock.
+ * Supply a different clock (like the ManualClock) for deterministic or faster than real-time metering.
+*/
+class Clock
+{
+public:
+    /** @brief Destructor.*/
+    virtual ~Clock() = default;
+
+    /**
+     * @brief Get the current time.
+     *
+     * @return The current time (in milliseconds).
+    */
+    [[nodiscard]] virtual double getMilliseconds() const noexcept = 0;
+
+    /**
+     * @brief Get the default (high resolution, real-time) clock.
+     *
+     * @return The default clock.
+    */
+    [[nodiscard]] static const Clock& getDefault() noexcept;
+};
+
+/**
+ * @brief High resolution real-time clock.
+*/
+class HighResolutionClock final : public Clock
+{
+public:
+    /** @internal */
+    [[nodiscard]] double getMilliseconds() const noexcept override { return juce::Time::getMillisecondCounterHiRes(); }
+};
+
+/**
+ * @brief Clock that only advances when told to.
+ *
+ * Use this for offline (faster than real-time) metering or for testing the meter ballistics.
+*/
+class ManualClock final : public Clock
+{
+public:
+    /**
+     * @brief Set the current time.
+     *
+     * @param time_ms The new time (in milliseconds).
+    */
+    void setMilliseconds (double time_ms) noexcept { m_time_ms = time_ms; }
+
+    /**
+     * @brief Advance the clock.
+     *
+     * @param duration_ms The amount of time to advance the clock with (in milliseconds).
+    */
+    void advance (double duration_ms) noexcept { m_time_ms += duration_ms; }
+
+    /** @internal */
+    [[nodiscard]] double getMilliseconds() const noexcept override { return m_time_ms; }
+
+private:
+    double m_time_ms = 0.0;
+};
+}  // namespace SoundMeter
+}  // namespace sd
@@ -0,0 +1,55 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief Level and timing constants of the meters.
+*/
+namespace Constants
+{
+static constexpr auto kMaxLevel_db             = 0.0f;     ///< Maximum meter level (in db).
+static constexpr auto kMinLevel_db             = -96.0f;   ///< Minimum meter level (in db).
+static constexpr auto kMinDecay_ms             = 100.0f;   ///< Minimum meter decay speed (in milliseconds).
+static constexpr auto kMaxDecay_ms             = 4000.0f;  ///< Maximum meter decay speed (in milliseconds).
+static constexpr auto kDefaultDecay_ms         = 1000.0f;  ///< Default meter decay speed (in milliseconds).
+static constexpr auto kPeakDefaultDecay_ms     = 2000.0f;  ///< Default meter decay speed (in milliseconds).
+static constexpr auto kDefaultScaleMin_db      = -60.0f;   ///< Bottom of the default meter scale (in db). All scales go up to kMaxLevel_db.
+static constexpr auto kSmpteScaleMin_db        = -44.0f;   ///< Bottom of the SMPTE meter scale (in db).
+static constexpr auto kYamaha60ScaleMin_db     = -60.0f;   ///< Bottom of the Yamaha mixer meter scale (in db).
+}  // namespace Constants
+}  // namespace SoundMeter
+}  // namespace sd
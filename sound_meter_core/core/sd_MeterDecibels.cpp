@@ -0,0 +1,97 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterDecibels.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+namespace Decibels
+{
+void gainToDecibels (const float* gains, float* decibels, int numValues, float minusInfinity_db /*= kMinusInfinity_db*/) noexcept
+{
+    if (gains == nullptr || decibels == nullptr)
+        return;
+
+    int valueIdx = 0;
+
+#if JUCE_USE_SSE_INTRINSICS
+    const auto minGain       = _mm_set1_ps (std::numeric_limits<float>::min());
+    const auto mantissaMask  = _mm_set1_epi32 (0x007fffff);
+    const auto one           = _mm_set1_epi32 (0x3f800000);
+    const auto bias          = _mm_set1_epi32 (127);
+    const auto minusInfinity = _mm_set1_ps (minusInfinity_db);
+
+    for (; valueIdx + 4 <= numValues; valueIdx += 4)
+    {
+        const auto gain     = _mm_castps_si128 (_mm_max_ps (_mm_loadu_ps (gains + valueIdx), minGain));  // Also replaces NaN.
+        const auto exponent = _mm_cvtepi32_ps (_mm_sub_epi32 (_mm_srli_epi32 (gain, 23), bias));
+        const auto x        = _mm_sub_ps (_mm_castsi128_ps (_mm_or_si128 (_mm_and_si128 (gain, mantissaMask), one)), _mm_set1_ps (1.0f));
+
+        auto poly = _mm_set1_ps (kLog2Coefficients[4]);
+        for (int coeff = 3; coeff >= 0; --coeff)
+            poly = _mm_add_ps (_mm_mul_ps (poly, x), _mm_set1_ps (kLog2Coefficients[coeff]));
+
+        const auto log2 = _mm_add_ps (exponent, _mm_mul_ps (poly, x));
+        _mm_storeu_ps (decibels + valueIdx, _mm_max_ps (_mm_mul_ps (log2, _mm_set1_ps (kDecibelsPerOctave)), minusInfinity));
+    }
+#elif JUCE_USE_ARM_NEON
+    const auto minGain       = vdupq_n_f32 (std::numeric_limits<float>::min());
+    const auto mantissaMask  = vdupq_n_u32 (0x007fffff);
+    const auto one           = vdupq_n_u32 (0x3f800000);
+    const auto bias          = vdupq_n_s32 (127);
+    const auto minusInfinity = vdupq_n_f32 (minusInfinity_db);
+
+    for (; valueIdx + 4 <= numValues; valueIdx += 4)
+    {
+        const auto input    = vld1q_f32 (gains + valueIdx);
+        const auto valid    = vcgtq_f32 (input, minGain);  // False for NaN.
+        const auto gain     = vreinterpretq_u32_f32 (vbslq_f32 (valid, input, minGain));
+        const auto exponent = vcvtq_f32_s32 (vsubq_s32 (vreinterpretq_s32_u32 (vshrq_n_u32 (gain, 23)), bias));
+        const auto x        = vsubq_f32 (vreinterpretq_f32_u32 (vorrq_u32 (vandq_u32 (gain, mantissaMask), one)), vdupq_n_f32 (1.0f));
+
+        auto poly = vdupq_n_f32 (kLog2Coefficients[4]);
+        for (int coeff = 3; coeff >= 0; --coeff)
+            poly = vmlaq_f32 (vdupq_n_f32 (kLog2Coefficients[coeff]), poly, x);
+
+        const auto log2 = vmlaq_f32 (exponent, poly, x);
+        vst1q_f32 (decibels + valueIdx, vmaxq_f32 (vmulq_n_f32 (log2, kDecibelsPerOctave), minusInfinity));
+    }
+#endif
+
+    for (; valueIdx < numValues; ++valueIdx)
+        decibels[valueIdx] = gainToDecibels (gains[valueIdx], minusInfinity_db);
+}
+}  // namespace Decibels
+}  // namespace SoundMeter
+}  // namespace sd
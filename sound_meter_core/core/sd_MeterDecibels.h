@@ -0,0 +1,93 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief Fast gain to decibels conversion.
+ *
+ * Replaces the std::log10 in juce::Decibels::gainToDecibels by a bit-level log2:
+ * the exponent of the float is taken as is, the log2 of the mantissa is approximated by a polynomial.
+ * The error is below 0.0001 dB, far below the resolution of any meter. Powers of 2 (including unity gain) are exact.
+*/
+namespace Decibels
+{
+static constexpr auto kMinusInfinity_db = -100.0f;  ///< Level returned for silence (in db), like juce::Decibels.
+
+// Approximation of log2 (1 + x) for x in [0, 1): x * (c1 + x * (c2 + x * (c3 + x * (c4 + x * c5)))).
+static constexpr float kLog2Coefficients[] = { 1.441917031f, -0.709096377f, 0.41560588f, -0.1935755156f, 0.0451489816f };
+static constexpr float kDecibelsPerOctave  = 6.020599913f;  // 20 * log10 (2).
+
+/**
+ * @brief Convert a gain to decibels.
+ *
+ * @param gain             The gain (in amp).
+ * @param minusInfinity_db The level returned for gains of zero (or below the level), negative gains or NaN.
+ * @return The level (in decibels).
+*/
+[[nodiscard]] inline float gainToDecibels (float gain, float minusInfinity_db = kMinusInfinity_db) noexcept
+{
+    gain = gain > std::numeric_limits<float>::min() ? gain : std::numeric_limits<float>::min();
+
+    uint32_t bits = 0;
+    std::memcpy (&bits, &gain, sizeof (bits));
+
+    const auto exponent = static_cast<float> (static_cast<int> (bits >> 23) - 127);
+    bits                = (bits & 0x007fffff) | 0x3f800000;
+    float mantissa      = 0.0f;
+    std::memcpy (&mantissa, &bits, sizeof (mantissa));
+
+    const auto x    = mantissa - 1.0f;
+    const auto log2 = exponent + x * (kLog2Coefficients[0] + x * (kLog2Coefficients[1] + x * (kLog2Coefficients[2] + x * (kLog2Coefficients[3] + x * kLog2Coefficients[4]))));
+    return std::max (minusInfinity_db, log2 * kDecibelsPerOctave);
+}
+
+/**
+ * @brief Convert a number of gains to decibels at once.
+ *
+ * Uses SIMD when available. The gains and the decibels can be the same array (in-place conversion).
+ *
+ * @param gains            The gains to convert (in amp).
+ * @param decibels         The array receiving the levels (in decibels).
+ * @param numValues        The number of values to convert.
+ * @param minusInfinity_db The level returned for gains of zero (or below the level), negative gains or NaN.
+*/
+void gainToDecibels (const float* gains, float* decibels, int numValues, float minusInfinity_db = kMinusInfinity_db) noexcept;
+}  // namespace Decibels
+}  // namespace SoundMeter
+}  // namespace sd
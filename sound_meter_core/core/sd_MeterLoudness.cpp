@@ -0,0 +1,398 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterLoudness.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+namespace
+{
+constexpr double kAbsoluteGate_lufs = -70.0;  // Absolute gating threshold.
+constexpr double kRelativeGate_lu   = -10.0;  // Relative gating threshold.
+
+[[nodiscard]] double powerToLoudness (double power) noexcept
+{
+    if (power <= 0.0)
+        return Constants::kMinLevel_db;
+    return std::max (static_cast<double> (Constants::kMinLevel_db), -0.691 + 10.0 * std::log10 (power));
+}
+}  // namespace
+//==============================================================================
+
+Loudness::Loudness()
+{
+    prepare (48000.0, { 1.0f, 1.0f });
+}
+//==============================================================================
+
+void Loudness::prepare (double sampleRate, const std::vector<float>& channelWeights)
+{
+    jassert (sampleRate > 0.0);  // NOLINT
+
+    // K-weighting pre-filter (high shelf), as specified in ITU-R BS.1770 for 48 kHz and re-calculated for the actual sample rate...
+    {
+        const auto k  = std::tan (juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+        const auto q  = 0.7071752369554196;
+        const auto vh = std::pow (10.0, 3.999843853973347 / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+        m_preFilter   = { (vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0, 2.0 * (k * k - 1.0) / a0,
+                          (1.0 - k / q + k * k) / a0 };
+    }
+    // ... and the RLB filter (high pass).
+    {
+        const auto k  = std::tan (juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+        const auto q  = 0.5003270373238773;
+        const auto a0 = 1.0 + k / q + k * k;
+        m_rlbFilter   = { 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+    }
+
+    m_numChannels = static_cast<int> (channelWeights.size());
+    m_blockSize   = std::max (1, juce::roundToInt (sampleRate / 10.0));
+    m_channelGroups.assign (static_cast<size_t> ((m_numChannels + kNumLanes - 1) / kNumLanes), ChannelGroup {});
+    for (int channelIdx = 0; channelIdx < m_numChannels; ++channelIdx)
+        m_channelGroups[static_cast<size_t> (channelIdx / kNumLanes)].weights[channelIdx % kNumLanes] = channelWeights[static_cast<size_t> (channelIdx)];
+
+    clearState();
+    m_blockFifo.reset();
+    reset();
+}
+//==============================================================================
+
+void Loudness::reset()
+{
+    // Discard the blocks measured before the reset...
+    m_blockFifo.finishedRead (m_blockFifo.getNumReady());
+    m_resetRequested.store (true);
+
+    m_recentBlocks.fill (0.0);
+    m_numRecentBlocks  = 0;
+    m_recentBlockIndex = 0;
+    std::fill (m_histogramCounts.begin(), m_histogramCounts.end(), uint64_t { 0 });
+    std::fill (m_histogramPowers.begin(), m_histogramPowers.end(), 0.0);
+    m_momentaryLoudness  = Constants::kMinLevel_db;
+    m_shortTermLoudness  = Constants::kMinLevel_db;
+    m_integratedLoudness = Constants::kMinLevel_db;
+}
+//==============================================================================
+
+void Loudness::clearState() noexcept
+{
+    for (auto& group: m_channelGroups)
+    {
+        std::fill (std::begin (group.preState1), std::end (group.preState1), 0.0);
+        std::fill (std::begin (group.preState2), std::end (group.preState2), 0.0);
+        std::fill (std::begin (group.rlbState1), std::end (group.rlbState1), 0.0);
+        std::fill (std::begin (group.rlbState2), std::end (group.rlbState2), 0.0);
+        std::fill (std::begin (group.power), std::end (group.power), 0.0);
+    }
+    m_blockSamplesDone = 0;
+}
+//==============================================================================
+
+void Loudness::process (const float* const* channelData, int numChannels, int numSamples) noexcept
+{
+    if (m_resetRequested.exchange (false))
+        clearState();
+
+    if (channelData == nullptr || numSamples <= 0)
+        return;
+
+    numChannels = std::min (numChannels, m_numChannels);
+
+    int startSample = 0;
+    while (startSample < numSamples)
+    {
+        const auto numBlockSamples = std::min (numSamples - startSample, m_blockSize - m_blockSamplesDone);
+
+        for (int groupIdx = 0; groupIdx * kNumLanes < numChannels; ++groupIdx)
+            processGroup (m_channelGroups[static_cast<size_t> (groupIdx)], channelData + groupIdx * kNumLanes,
+                          std::min (kNumLanes, numChannels - groupIdx * kNumLanes), startSample, numBlockSamples);
+
+        startSample += numBlockSamples;
+        m_blockSamplesDone += numBlockSamples;
+        if (m_blockSamplesDone < m_blockSize)
+            continue;
+
+        // A 100 ms block is finished. Hand the weighted power over to the GUI thread...
+        auto blockPower = 0.0;
+        for (auto& group: m_channelGroups)
+        {
+            for (int lane = 0; lane < kNumLanes; ++lane)
+                blockPower += group.weights[lane] * group.power[lane];
+            std::fill (std::begin (group.power), std::end (group.power), 0.0);
+        }
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;  // NOLINT
+        m_blockFifo.prepareToWrite (1, start1, size1, start2, size2);
+        if (size1 > 0)
+            m_blockFifoData[static_cast<size_t> (start1)] = blockPower / m_blockSize;
+        m_blockFifo.finishedWrite (size1);
+
+        m_blockSamplesDone = 0;
+    }
+}
+//==============================================================================
+
+void Loudness::processGroup (ChannelGroup& group, const float* const* channelData, int numChannels, int startSample, int numSamples) const noexcept
+{
+    const auto pre = m_preFilter;
+    const auto rlb = m_rlbFilter;
+
+    // Gather a sample of every channel in the group (silent lanes stay at 0)...
+    alignas (16) double input[kNumLanes] = {};  // NOLINT
+    auto gatherInput = [&input, channelData, numChannels] (int sampleIdx) noexcept
+    {
+        for (int lane = 0; lane < numChannels; ++lane)
+            input[lane] = channelData[lane][sampleIdx];
+    };
+
+#if JUCE_USE_SSE_INTRINSICS || (JUCE_USE_ARM_NEON && JUCE_64BIT)
+    // Two lanes (doubles) per register, so the group takes two registers...
+    constexpr int kNumRegisters = kNumLanes / 2;
+#endif
+
+#if JUCE_USE_SSE_INTRINSICS
+    const auto preB0 = _mm_set1_pd (pre.b0), preB1 = _mm_set1_pd (pre.b1), preB2 = _mm_set1_pd (pre.b2), preA1 = _mm_set1_pd (pre.a1), preA2 = _mm_set1_pd (pre.a2);
+    const auto rlbB0 = _mm_set1_pd (rlb.b0), rlbB1 = _mm_set1_pd (rlb.b1), rlbB2 = _mm_set1_pd (rlb.b2), rlbA1 = _mm_set1_pd (rlb.a1), rlbA2 = _mm_set1_pd (rlb.a2);
+
+    __m128d preState1[kNumRegisters], preState2[kNumRegisters], rlbState1[kNumRegisters], rlbState2[kNumRegisters], power[kNumRegisters];  // NOLINT
+    for (int reg = 0; reg < kNumRegisters; ++reg)
+    {
+        preState1[reg] = _mm_load_pd (group.preState1 + reg * 2);
+        preState2[reg] = _mm_load_pd (group.preState2 + reg * 2);
+        rlbState1[reg] = _mm_load_pd (group.rlbState1 + reg * 2);
+        rlbState2[reg] = _mm_load_pd (group.rlbState2 + reg * 2);
+        power[reg]     = _mm_load_pd (group.power + reg * 2);
+    }
+
+    for (int sampleIdx = startSample; sampleIdx < startSample + numSamples; ++sampleIdx)
+    {
+        gatherInput (sampleIdx);
+
+        for (int reg = 0; reg < kNumRegisters; ++reg)
+        {
+            const auto x      = _mm_load_pd (input + reg * 2);
+            const auto preOut = _mm_add_pd (_mm_mul_pd (preB0, x), preState1[reg]);
+            preState1[reg]    = _mm_add_pd (_mm_sub_pd (_mm_mul_pd (preB1, x), _mm_mul_pd (preA1, preOut)), preState2[reg]);
+            preState2[reg]    = _mm_sub_pd (_mm_mul_pd (preB2, x), _mm_mul_pd (preA2, preOut));
+
+            const auto rlbOut = _mm_add_pd (_mm_mul_pd (rlbB0, preOut), rlbState1[reg]);
+            rlbState1[reg]    = _mm_add_pd (_mm_sub_pd (_mm_mul_pd (rlbB1, preOut), _mm_mul_pd (rlbA1, rlbOut)), rlbState2[reg]);
+            rlbState2[reg]    = _mm_sub_pd (_mm_mul_pd (rlbB2, preOut), _mm_mul_pd (rlbA2, rlbOut));
+
+            power[reg] = _mm_add_pd (power[reg], _mm_mul_pd (rlbOut, rlbOut));
+        }
+    }
+
+    for (int reg = 0; reg < kNumRegisters; ++reg)
+    {
+        _mm_store_pd (group.preState1 + reg * 2, preState1[reg]);
+        _mm_store_pd (group.preState2 + reg * 2, preState2[reg]);
+        _mm_store_pd (group.rlbState1 + reg * 2, rlbState1[reg]);
+        _mm_store_pd (group.rlbState2 + reg * 2, rlbState2[reg]);
+        _mm_store_pd (group.power + reg * 2, power[reg]);
+    }
+#elif JUCE_USE_ARM_NEON && JUCE_64BIT
+    // Separate multiplies and adds (no fused multiply-add), so the results match the other paths...
+    const auto preB0 = vdupq_n_f64 (pre.b0), preB1 = vdupq_n_f64 (pre.b1), preB2 = vdupq_n_f64 (pre.b2), preA1 = vdupq_n_f64 (pre.a1), preA2 = vdupq_n_f64 (pre.a2);
+    const auto rlbB0 = vdupq_n_f64 (rlb.b0), rlbB1 = vdupq_n_f64 (rlb.b1), rlbB2 = vdupq_n_f64 (rlb.b2), rlbA1 = vdupq_n_f64 (rlb.a1), rlbA2 = vdupq_n_f64 (rlb.a2);
+
+    float64x2_t preState1[kNumRegisters], preState2[kNumRegisters], rlbState1[kNumRegisters], rlbState2[kNumRegisters], power[kNumRegisters];  // NOLINT
+    for (int reg = 0; reg < kNumRegisters; ++reg)
+    {
+        preState1[reg] = vld1q_f64 (group.preState1 + reg * 2);
+        preState2[reg] = vld1q_f64 (group.preState2 + reg * 2);
+        rlbState1[reg] = vld1q_f64 (group.rlbState1 + reg * 2);
+        rlbState2[reg] = vld1q_f64 (group.rlbState2 + reg * 2);
+        power[reg]     = vld1q_f64 (group.power + reg * 2);
+    }
+
+    for (int sampleIdx = startSample; sampleIdx < startSample + numSamples; ++sampleIdx)
+    {
+        gatherInput (sampleIdx);
+
+        for (int reg = 0; reg < kNumRegisters; ++reg)
+        {
+            const auto x      = vld1q_f64 (input + reg * 2);
+            const auto preOut = vaddq_f64 (vmulq_f64 (preB0, x), preState1[reg]);
+            preState1[reg]    = vaddq_f64 (vsubq_f64 (vmulq_f64 (preB1, x), vmulq_f64 (preA1, preOut)), preState2[reg]);
+            preState2[reg]    = vsubq_f64 (vmulq_f64 (preB2, x), vmulq_f64 (preA2, preOut));
+
+            const auto rlbOut = vaddq_f64 (vmulq_f64 (rlbB0, preOut), rlbState1[reg]);
+            rlbState1[reg]    = vaddq_f64 (vsubq_f64 (vmulq_f64 (rlbB1, preOut), vmulq_f64 (rlbA1, rlbOut)), rlbState2[reg]);
+            rlbState2[reg]    = vsubq_f64 (vmulq_f64 (rlbB2, preOut), vmulq_f64 (rlbA2, rlbOut));
+
+            power[reg] = vaddq_f64 (power[reg], vmulq_f64 (rlbOut, rlbOut));
+        }
+    }
+
+    for (int reg = 0; reg < kNumRegisters; ++reg)
+    {
+        vst1q_f64 (group.preState1 + reg * 2, preState1[reg]);
+        vst1q_f64 (group.preState2 + reg * 2, preState2[reg]);
+        vst1q_f64 (group.rlbState1 + reg * 2, rlbState1[reg]);
+        vst1q_f64 (group.rlbState2 + reg * 2, rlbState2[reg]);
+        vst1q_f64 (group.power + reg * 2, power[reg]);
+    }
+#else
+    for (int sampleIdx = startSample; sampleIdx < startSample + numSamples; ++sampleIdx)
+    {
+        gatherInput (sampleIdx);
+
+        for (int lane = 0; lane < kNumLanes; ++lane)
+        {
+            const auto preOut     = pre.b0 * input[lane] + group.preState1[lane];
+            group.preState1[lane] = pre.b1 * input[lane] - pre.a1 * preOut + group.preState2[lane];
+            group.preState2[lane] = pre.b2 * input[lane] - pre.a2 * preOut;
+
+            const auto rlbOut     = rlb.b0 * preOut + group.rlbState1[lane];
+            group.rlbState1[lane] = rlb.b1 * preOut - rlb.a1 * rlbOut + group.rlbState2[lane];
+            group.rlbState2[lane] = rlb.b2 * preOut - rlb.a2 * rlbOut;
+
+            group.power[lane] += rlbOut * rlbOut;
+        }
+    }
+#endif
+}
+//==============================================================================
+
+void Loudness::update()
+{
+    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;  // NOLINT
+    m_blockFifo.prepareToRead (m_blockFifo.getNumReady(), start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+        return;
+
+    for (int idx = start1; idx < start1 + size1; ++idx)
+        addBlock (m_blockFifoData[static_cast<size_t> (idx)]);
+    for (int idx = start2; idx < start2 + size2; ++idx)
+        addBlock (m_blockFifoData[static_cast<size_t> (idx)]);
+    m_blockFifo.finishedRead (size1 + size2);
+
+    if (m_numRecentBlocks >= kNumMomentaryBlocks)
+        m_momentaryLoudness = static_cast<float> (powerToLoudness (getAveragePower (kNumMomentaryBlocks)));
+    if (m_numRecentBlocks >= kNumShortTermBlocks)
+        m_shortTermLoudness = static_cast<float> (powerToLoudness (getAveragePower (kNumShortTermBlocks)));
+
+    calculateIntegratedLoudness();
+}
+//==============================================================================
+
+void Loudness::addBlock (double power)
+{
+    m_recentBlocks[static_cast<size_t> (m_recentBlockIndex)] = power;
+    m_recentBlockIndex                                       = (m_recentBlockIndex + 1) % kNumShortTermBlocks;
+    m_numRecentBlocks                                        = std::min (m_numRecentBlocks + 1, kNumShortTermBlocks);
+
+    if (m_numRecentBlocks < kNumMomentaryBlocks)
+        return;
+
+    // Every 100 ms block completes a 400 ms gating block (75% overlap)...
+    const auto gatingPower    = getAveragePower (kNumMomentaryBlocks);
+    const auto gatingLoudness = powerToLoudness (gatingPower);
+    if (gatingLoudness <= kAbsoluteGate_lufs)
+        return;
+
+    const auto bin = std::min (static_cast<int> ((gatingLoudness - kAbsoluteGate_lufs) * kHistogramBinsPerLu), kNumHistogramBins - 1);
+    m_histogramCounts[static_cast<size_t> (bin)]++;
+    m_histogramPowers[static_cast<size_t> (bin)] += gatingPower;
+}
+//==============================================================================
+
+double Loudness::getAveragePower (int numBlocks) const noexcept
+{
+    auto total = 0.0;
+    for (int block = 1; block <= numBlocks; ++block)
+        total += m_recentBlocks[static_cast<size_t> ((m_recentBlockIndex - block + kNumShortTermBlocks) % kNumShortTermBlocks)];
+    return total / numBlocks;
+}
+//==============================================================================
+
+void Loudness::calculateIntegratedLoudness()
+{
+    // Absolute gate (blocks below it never made it into the histogram)...
+    uint64_t numBlocks  = 0;
+    auto     totalPower = 0.0;
+    for (int bin = 0; bin < kNumHistogramBins; ++bin)
+    {
+        numBlocks += m_histogramCounts[static_cast<size_t> (bin)];
+        totalPower += m_histogramPowers[static_cast<size_t> (bin)];
+    }
+    if (numBlocks == 0)
+        return;
+
+    // Relative gate. Bins are included when their centre is above the gate...
+    const auto relativeGate = powerToLoudness (totalPower / static_cast<double> (numBlocks)) + kRelativeGate_lu;
+    const auto firstBin     = juce::jlimit (0, kNumHistogramBins, static_cast<int> (std::ceil ((relativeGate - kAbsoluteGate_lufs) * kHistogramBinsPerLu - 0.5)));
+
+    numBlocks  = 0;
+    totalPower = 0.0;
+    for (int bin = firstBin; bin < kNumHistogramBins; ++bin)
+    {
+        numBlocks += m_histogramCounts[static_cast<size_t> (bin)];
+        totalPower += m_histogramPowers[static_cast<size_t> (bin)];
+    }
+
+    m_integratedLoudness = numBlocks > 0 ? static_cast<float> (powerToLoudness (totalPower / static_cast<double> (numBlocks))) : Constants::kMinLevel_db;
+}
+//==============================================================================
+
+float Loudness::getChannelWeight (juce::AudioChannelSet::ChannelType channelType) noexcept
+{
+    switch (channelType)
+    {
+        case juce::AudioChannelSet::LFE:
+        case juce::AudioChannelSet::LFE2: return 0.0f;
+        case juce::AudioChannelSet::leftSurround:
+        case juce::AudioChannelSet::rightSurround:
+        case juce::AudioChannelSet::leftSurroundSide:
+        case juce::AudioChannelSet::rightSurroundSide:
+        case juce::AudioChannelSet::leftSurroundRear:
+        case juce::AudioChannelSet::rightSurroundRear: return 1.41f;
+        default: return 1.0f;
+    }
+}
+//==============================================================================
+
+std::vector<float> Loudness::getChannelWeights (const juce::AudioChannelSet& channelFormat)
+{
+    std::vector<float> weights;
+    for (int channelIdx = 0; channelIdx < channelFormat.size(); ++channelIdx)
+        weights.emplace_back (getChannelWeight (channelFormat.getTypeOfChannel (channelIdx)));
+    return weights;
+}
+//==============================================================================
+}  // namespace SoundMeter
+}  // namespace sd
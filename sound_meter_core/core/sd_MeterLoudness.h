@@ -0,0 +1,192 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include "sd_MeterConstants.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief Loudness meter engine (EBU R128 / ITU-R BS.1770).
+ *
+ * The audio thread K-weights the audio (processing several channels at once) and measures the power of
+ * consecutive 100 ms blocks. Finished blocks are handed to the GUI thread via a lock-free fifo.
+ * From those, the GUI thread calculates the momentary (400 ms), short-term (3 s) and integrated loudness.
+ *
+ * The integrated loudness is gated using a histogram of the 400 ms gating blocks,
+ * so memory use is constant no matter how long the measurement runs.
+*/
+class Loudness final
+{
+public:
+    /** @brief Constructor.*/
+    Loudness();
+
+    /**
+     * @brief Prepare the loudness engine.
+     *
+     * Beware: this allocates, so never call this while the audio engine is processing!
+     *
+     * @param sampleRate     The sample rate of the audio.
+     * @param channelWeights The weight of every channel (see getChannelWeight).
+     *
+     * @see getChannelWeight
+    */
+    void prepare (double sampleRate, const std::vector<float>& channelWeights);
+
+    /**
+     * @brief Reset the measurement (including the integrated loudness).
+     *
+     * Called from the GUI thread. The audio thread will clear it's filter state when it processes the next block.
+    */
+    void reset();
+
+    /**
+     * @brief Process a block of audio.
+     *
+     * Beware: called from the audio thread!
+     * Channels beyond the prepared number of channels are ignored.
+     *
+     * @param channelData Pointers to the samples of each channel.
+     * @param numChannels The number of channels in the block.
+     * @param numSamples  The number of samples (per channel) in the block.
+    */
+    void process (const float* const* channelData, int numChannels, int numSamples) noexcept;
+
+    /**
+     * @brief Collect the blocks measured by the audio thread and update the loudness values.
+     *
+     * Called from the GUI thread (for instance, when refreshing the meters).
+    */
+    void update();
+
+    /**
+     * @brief Get the momentary loudness (400 ms window).
+     * @return The momentary loudness (in LUFS).
+    */
+    [[nodiscard]] float getMomentaryLoudness() const noexcept { return m_momentaryLoudness; }
+
+    /**
+     * @brief Get the short-term loudness (3 s window).
+     * @return The short-term loudness (in LUFS).
+    */
+    [[nodiscard]] float getShortTermLoudness() const noexcept { return m_shortTermLoudness; }
+
+    /**
+     * @brief Get the (gated) integrated loudness since the last reset.
+     * @return The integrated loudness (in LUFS).
+    */
+    [[nodiscard]] float getIntegratedLoudness() const noexcept { return m_integratedLoudness; }
+
+    /**
+     * @brief Get the weight of a channel in the loudness measurement.
+     *
+     * LFE channels are excluded, surround channels are weighted +1.5 dB.
+     *
+     * @param channelType The type of the channel.
+     * @return The weight of the channel.
+    */
+    [[nodiscard]] static float getChannelWeight (juce::AudioChannelSet::ChannelType channelType) noexcept;
+
+    /**
+     * @brief Get the weights of all channels in a channel format.
+     *
+     * @param channelFormat The channel format.
+     * @return The weight of every channel in the format.
+    */
+    [[nodiscard]] static std::vector<float> getChannelWeights (const juce::AudioChannelSet& channelFormat);
+
+    static constexpr int kNumLanes = 4;  ///< Number of channels K-weighted simultaneously.
+
+private:
+    static constexpr int kNumMomentaryBlocks  = 4;     // 100 ms blocks in the momentary window (and in a gating block).
+    static constexpr int kNumShortTermBlocks  = 30;    // 100 ms blocks in the short-term window.
+    static constexpr int kNumHistogramBins    = 1000;  // Loudness bins from -70 LUFS up to +30 LUFS...
+    static constexpr int kHistogramBinsPerLu  = 10;    // ... with a 0.1 LU resolution.
+    static constexpr int kFifoSize            = 1024;  // Over 100 s of blocks, before the GUI thread has to pick them up.
+
+    // K-weighting filter coefficients (pre-filter and RLB filter, cascaded).
+    struct Coefficients
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    // Filter state and block power of a group of channels, one lane per channel.
+    struct ChannelGroup
+    {
+        alignas (16) double preState1[kNumLanes] {};
+        alignas (16) double preState2[kNumLanes] {};
+        alignas (16) double rlbState1[kNumLanes] {};
+        alignas (16) double rlbState2[kNumLanes] {};
+        alignas (16) double power[kNumLanes] {};
+        alignas (16) double weights[kNumLanes] {};
+    };
+
+    // Audio thread...
+    Coefficients              m_preFilter {};
+    Coefficients              m_rlbFilter {};
+    std::vector<ChannelGroup> m_channelGroups {};
+    int                       m_numChannels         = 0;
+    int                       m_blockSize           = 4800;  // Samples per 100 ms block.
+    int                       m_blockSamplesDone    = 0;
+    std::atomic<bool>         m_resetRequested { false };
+
+    // Hand-over of finished 100 ms blocks (weighted power) to the GUI thread...
+    juce::AbstractFifo  m_blockFifo { kFifoSize };
+    std::vector<double> m_blockFifoData = std::vector<double> (static_cast<size_t> (kFifoSize), 0.0);
+
+    // GUI thread...
+    std::array<double, kNumShortTermBlocks> m_recentBlocks {};  // Power of the latest 100 ms blocks.
+    int                                     m_numRecentBlocks    = 0;
+    int                                     m_recentBlockIndex   = 0;
+    std::vector<uint64_t>                   m_histogramCounts    = std::vector<uint64_t> (kNumHistogramBins, 0);  // Number of gating blocks per bin.
+    std::vector<double>                     m_histogramPowers    = std::vector<double> (kNumHistogramBins, 0.0);  // Total power of the gating blocks per bin.
+    float                                   m_momentaryLoudness  = Constants::kMinLevel_db;
+    float                                   m_shortTermLoudness  = Constants::kMinLevel_db;
+    float                                   m_integratedLoudness = Constants::kMinLevel_db;
+
+    void                 processGroup (ChannelGroup& group, const float* const* channelData, int numChannels, int startSample, int numSamples) const noexcept;
+    void                 clearState() noexcept;
+    void                 addBlock (double power);
+    void                 calculateIntegratedLoudness();
+    [[nodiscard]] double getAveragePower (int numBlocks) const noexcept;
+
+    JUCE_LEAK_DETECTOR (Loudness)
+};
+}  // namespace SoundMeter
+}  // namespace sd
@@ -0,0 +1,233 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterOffline.h"
+
+#include "sd_MeterAudioHelpers.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+OfflineMeter::OfflineMeter (const OfflineOptions& options /*= {}*/)
+{
+    m_meterBank.setClock (&m_clock);
+    setOptions (options);
+}
+//==============================================================================
+
+void OfflineMeter::setOptions (const OfflineOptions& options)
+{
+    m_options           = options;
+    m_options.frameRate = std::max (1.0, options.frameRate);
+    m_options.blockSize = std::max (1, options.blockSize);
+}
+//==============================================================================
+
+OfflineResult OfflineMeter::process (juce::AudioFormatReader& reader, juce::int64 startSample /*= 0*/, juce::int64 numSamples /*= -1*/)
+{
+    OfflineResult result;
+    if (reader.sampleRate <= 0.0 || reader.numChannels <= 0)
+        return result;
+
+    startSample          = juce::jlimit (juce::int64 { 0 }, reader.lengthInSamples, startSample);
+    const auto endSample = numSamples < 0 ? reader.lengthInSamples : std::min (reader.lengthInSamples, startSample + numSamples);
+
+    prepare (reader, result);
+    result.numSamplesRequested = endSample - startSample;
+
+    const auto samplesPerFrame = reader.sampleRate / result.frameRate;
+    const auto startTime_ms    = m_clock.getMilliseconds();  // The clock never goes back, so the bank can be re-used for the next file.
+    const auto expectedFrames  = static_cast<size_t> (std::ceil (static_cast<double> (endSample - startSample) / samplesPerFrame));
+    result.meterLevels_db.reserve (expectedFrames * static_cast<size_t> (result.numChannels));
+    result.peakHoldLevels_db.reserve (expectedFrames * static_cast<size_t> (result.numChannels));
+
+    // Refresh the bank at the end of every frame, timing it by the audio that was fed to it...
+    auto finishFrame = [&] (juce::int64 frameEnd)
+    {
+        m_clock.setMilliseconds (startTime_ms + static_cast<double> (frameEnd - startSample) * 1000.0 / reader.sampleRate);
+        m_meterBank.refresh();
+        if (m_options.loudnessEnabled)
+            m_loudness.update();
+        addFrame (result);
+    };
+    auto getFrameEnd = [&] (int frame) { return startSample + static_cast<juce::int64> (std::llround (static_cast<double> (frame + 1) * samplesPerFrame)); };
+
+    std::vector<const float*> channelData (static_cast<size_t> (result.numChannels), nullptr);
+    auto                      frameStart = startSample;
+    auto                      frameEnd   = getFrameEnd (0);
+    auto                      position   = startSample;
+    while (position < endSample)
+    {
+        const auto blockSize = static_cast<int> (std::min (static_cast<juce::int64> (m_buffer.getNumSamples()), endSample - position));
+        if (!reader.read (&m_buffer, 0, blockSize, position, true, true))
+        {
+            result.readFailed = true;  // Corrupt or truncated file: report what was metered up to here.
+            break;
+        }
+
+        // Split the block at the frame boundaries...
+        for (int offset = 0; offset < blockSize;)
+        {
+            const auto chunkSize = static_cast<int> (std::min (static_cast<juce::int64> (blockSize - offset), frameEnd - (position + offset)));
+            for (int channelIdx = 0; channelIdx < result.numChannels; ++channelIdx)
+                channelData[static_cast<size_t> (channelIdx)] = m_buffer.getReadPointer (channelIdx, offset);
+
+            processChunk (channelData.data(), chunkSize, result);
+            offset += chunkSize;
+
+            if (position + offset == frameEnd)
+            {
+                finishFrame (frameEnd);
+                frameStart = frameEnd;
+                frameEnd   = getFrameEnd (result.numFrames);
+            }
+        }
+        position += blockSize;
+    }
+
+    // The last (partial) frame...
+    if (position > frameStart)
+        finishFrame (position);
+
+    result.numSamplesMetered = position - startSample;
+
+    if (m_options.loudnessEnabled)
+        result.integratedLoudness = m_loudness.getIntegratedLoudness();
+
+    return result;
+}
+//==============================================================================
+
+float OfflineMeter::getFullScale (const juce::AudioFormatReader& reader) noexcept
+{
+    if (reader.usesFloatingPointData || reader.bitsPerSample < 2)
+        return 1.0f;
+    return 1.0f - std::ldexp (1.0f, 1 - static_cast<int> (reader.bitsPerSample));
+}
+//==============================================================================
+
+void OfflineMeter::prepare (const juce::AudioFormatReader& reader, OfflineResult& result)
+{
+    const auto numChannels = static_cast<int> (reader.numChannels);
+
+    result.numChannels = numChannels;
+    result.frameRate   = std::min (m_options.frameRate, reader.sampleRate);  // At least one sample per frame.
+    result.maxSamplePeaks.assign (static_cast<size_t> (numChannels), 0.0f);
+    result.maxTruePeaks.assign (static_cast<size_t> (numChannels), 0.0f);
+    result.numClippedSamples.assign (static_cast<size_t> (numChannels), 0);
+
+    // Exactly the configuration the meters use...
+    m_meterBank.setNumChannels (numChannels);
+    m_meterBank.setBallistics (m_options.ballistics, m_options.decayTime_ms);
+    m_meterBank.setPeakHoldTime (m_options.peakDecayTime_ms);
+    m_meterBank.setPeakFallRate (m_options.peakFallRate);
+    m_meterBank.setLevelRange (m_options.levelRange);
+    m_meterBank.setSampleAccurate (m_options.sampleAccurateBallistics);
+    m_meterBank.setSampleRate (reader.sampleRate);
+
+    m_truePeakDetector.prepare (numChannels);
+    if (m_options.loudnessEnabled)
+        m_loudness.prepare (reader.sampleRate, Loudness::getChannelWeights (reader.getChannelLayout()));
+
+    m_buffer.setSize (numChannels, m_options.blockSize, false, false, true);
+    m_framePeaks.assign (static_cast<size_t> (numChannels), 0.0f);
+    m_clipping.assign (static_cast<size_t> (numChannels), 0);
+    m_fullScale = getFullScale (reader);
+}
+//==============================================================================
+
+void OfflineMeter::processChunk (const float* const* channelData, int numSamples, OfflineResult& result) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    for (int channelIdx = 0; channelIdx < result.numChannels; ++channelIdx)
+    {
+        const auto  channel = static_cast<size_t> (channelIdx);
+        const auto* samples = channelData[channelIdx];
+
+        const auto samplePeak          = Helpers::getPeakLevel (samples, numSamples);
+        result.maxSamplePeaks[channel] = std::max (result.maxSamplePeaks[channel], samplePeak);
+        if (samplePeak >= m_fullScale)
+            result.numClippedSamples[channel] += std::count_if (samples, samples + numSamples, [this] (float sample) { return std::abs (sample) >= m_fullScale; });
+
+        const auto truePeak          = m_truePeakDetector.process (channelIdx, samples, numSamples);
+        result.maxTruePeaks[channel] = std::max (result.maxTruePeaks[channel], truePeak);
+
+        const auto peak = m_options.truePeakEnabled ? truePeak : samplePeak;
+
+        if (m_options.sampleAccurateBallistics)
+            m_meterBank.setInputBlockLevel (channelIdx, peak, numSamples);
+        else
+            m_meterBank.setInputLevel (channelIdx, peak);
+
+        m_framePeaks[channel] = std::max (m_framePeaks[channel], peak);
+    }
+
+    if (m_options.loudnessEnabled)
+        m_loudness.process (channelData, result.numChannels, numSamples);
+}
+//==============================================================================
+
+void OfflineMeter::addFrame (OfflineResult& result)
+{
+    const auto numChannels = static_cast<size_t> (result.numChannels);
+
+    const auto* meterLevels = m_meterBank.getMeterLevels();
+    result.meterLevels_db.insert (result.meterLevels_db.end(), meterLevels, meterLevels + numChannels);
+    const auto* peakHoldLevels = m_meterBank.getPeakHoldLevels();
+    result.peakHoldLevels_db.insert (result.peakHoldLevels_db.end(), peakHoldLevels, peakHoldLevels + numChannels);
+
+    if (m_options.loudnessEnabled)
+    {
+        result.momentaryLoudness.push_back (m_loudness.getMomentaryLoudness());
+        result.shortTermLoudness.push_back (m_loudness.getShortTermLoudness());
+    }
+
+    // A clip event is the start of a run of frames reaching full scale (where the clip indicator would light up)...
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        const auto clipping = static_cast<uint8_t> (m_framePeaks[channel] >= m_fullScale);
+        if (clipping != 0 && m_clipping[channel] == 0)
+            result.clipEvents.push_back ({ result.numFrames, static_cast<int> (channel) });
+
+        m_clipping[channel]   = clipping;
+        m_framePeaks[channel] = 0.0f;
+    }
+
+    ++result.numFrames;
+}
+//==============================================================================
+
+}  // namespace SoundMeter
+}  // namespace sd
@@ -0,0 +1,184 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include "sd_MeterBallistics.h"
+#include "sd_MeterBank.h"
+#include "sd_MeterClock.h"
+#include "sd_MeterConstants.h"
+#include "sd_MeterLoudness.h"
+#include "sd_MeterTruePeak.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief Options of the offline meter.
+ *
+ * The metering options have the same names and meaning as those in the (GUI) meter options,
+ * so a file can be metered exactly like it would be on screen.
+*/
+struct OfflineOptions
+{
+    double             frameRate                = 30.0;   ///< Frames per second of the time series (the 'refresh rate' of the offline meters).
+    int                blockSize                = 65536;  ///< Number of samples (per channel) read from the file at once.
+    BallisticsType     ballistics               = BallisticsType::linear;           ///< Meter ballistics.
+    float              decayTime_ms             = Constants::kDefaultDecay_ms;      ///< Meter decay in milliseconds.
+    float              peakDecayTime_ms         = Constants::kPeakDefaultDecay_ms;  ///< Peak hold window in milliseconds.
+    float              peakFallRate             = 0.0f;   ///< Rate (in dB per second) at which the peak hold falls back, or 0 to fall back at once.
+    juce::Range<float> levelRange               = { Constants::kMinLevel_db, Constants::kMaxLevel_db };  ///< Level range of the meters (in decibels).
+    bool               sampleAccurateBallistics = false;  ///< Calculate the ballistics per block of audio, instead of per frame.
+    bool               truePeakEnabled          = false;  ///< Meter true-peak levels instead of sample peaks (the maximum true-peak is always measured).
+    bool               loudnessEnabled          = false;  ///< Measure the loudness (momentary, short-term and integrated).
+};
+
+/**
+ * @brief A clip event: the start of a run of frames in which a channel reached full scale.
+*/
+struct ClipEvent
+{
+    int frame   = 0;  ///< The frame in which the channel started clipping.
+    int channel = 0;  ///< The channel that clipped.
+};
+
+/**
+ * @brief The time series measured by the offline meter.
+ *
+ * Levels are stored frame after frame, with all channels of a frame next to each other.
+*/
+struct OfflineResult
+{
+    int    numChannels = 0;    ///< Number of channels metered.
+    int    numFrames   = 0;    ///< Number of frames in the time series.
+    double frameRate   = 0.0;  ///< Frames per second.
+
+    juce::int64 numSamplesRequested = 0;      ///< Number of samples (per channel) that should have been metered.
+    juce::int64 numSamplesMetered   = 0;      ///< Number of samples (per channel) actually metered. Less than requested when reading failed.
+    bool        readFailed          = false;  ///< Reading from the file failed, so only the first numSamplesMetered samples were metered.
+
+    std::vector<float>     meterLevels_db {};     ///< Meter level (including ballistics) of every channel in every frame.
+    std::vector<float>     peakHoldLevels_db {};  ///< Peak hold level of every channel in every frame.
+    std::vector<ClipEvent> clipEvents {};         ///< All clip events, in order.
+    std::vector<float>     momentaryLoudness {};  ///< Momentary loudness (in LUFS) of every frame. Empty when loudness is disabled.
+    std::vector<float>     shortTermLoudness {};  ///< Short-term loudness (in LUFS) of every frame. Empty when loudness is disabled.
+    float                  integratedLoudness = Constants::kMinLevel_db;  ///< Integrated loudness (in LUFS) of the whole file.
+
+    std::vector<float>       maxSamplePeaks {};      ///< Maximum sample peak (in amp) of every channel.
+    std::vector<float>       maxTruePeaks {};        ///< Maximum true-peak (in amp) of every channel.
+    std::vector<juce::int64> numClippedSamples {};   ///< Number of samples at (or over) full scale of every channel (see OfflineMeter::getFullScale).
+
+    /** @brief Get the time of a frame (in seconds), at the end of the frame. */
+    [[nodiscard]] double getTime (int frame) const noexcept { return static_cast<double> (frame + 1) / frameRate; }
+
+    /** @brief Get the meter level (in decibels) of a channel in a frame. */
+    [[nodiscard]] float getMeterLevel (int frame, int channel) const noexcept { return meterLevels_db[static_cast<size_t> (frame * numChannels + channel)]; }
+
+    /** @brief Get the peak hold level (in decibels) of a channel in a frame. */
+    [[nodiscard]] float getPeakHoldLevel (int frame, int channel) const noexcept { return peakHoldLevels_db[static_cast<size_t> (frame * numChannels + channel)]; }
+};
+
+/**
+ * @brief Faster than real-time file metering.
+ *
+ * Reads a file in large blocks and feeds it through the same meter bank as the on-screen meters,
+ * refreshing it at the frame rate using a manual clock. The levels are exactly those the meters would show
+ * (when refreshed at the same rate), but the file is metered as fast as the CPU allows.
+ *
+ * Only available when the juce_audio_formats module is part of the project.
+*/
+class OfflineMeter final
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param options The options to meter with.
+    */
+    explicit OfflineMeter (const OfflineOptions& options = {});
+
+    /**
+     * @brief Set the options to meter with.
+     * @param options The options to meter with.
+    */
+    void setOptions (const OfflineOptions& options);
+
+    /**
+     * @brief Get the options to meter with.
+     * @return The options to meter with.
+    */
+    [[nodiscard]] const OfflineOptions& getOptions() const noexcept { return m_options; }
+
+    /**
+     * @brief Meter (part of) a file.
+     *
+     * @param reader      The reader of the file.
+     * @param startSample The first sample to meter.
+     * @param numSamples  The number of samples to meter, or -1 to meter up to the end of the file.
+     * @return The time series of the metered levels. When reading fails, metering stops and OfflineResult::readFailed is set.
+    */
+    [[nodiscard]] OfflineResult process (juce::AudioFormatReader& reader, juce::int64 startSample = 0, juce::int64 numSamples = -1);
+
+    /**
+     * @brief Get the level at which the samples of a file count as full scale (clipping).
+     *
+     * Integer PCM readers scale by 1 / 2^(bits - 1), so the largest positive sample is one step below 1.0.
+     *
+     * @param reader The reader of the file.
+     * @return The full scale level (in amp): 1.0 for floating point files, one step below 1.0 for integer ones.
+    */
+    [[nodiscard]] static float getFullScale (const juce::AudioFormatReader& reader) noexcept;
+
+private:
+    OfflineOptions           m_options {};
+    MeterBank                m_meterBank {};
+    ManualClock              m_clock {};
+    TruePeakDetector         m_truePeakDetector {};
+    Loudness                 m_loudness {};
+    juce::AudioBuffer<float> m_buffer {};
+    std::vector<float>       m_framePeaks {};     // Peak of every channel in the current frame (in amp).
+    std::vector<uint8_t>     m_clipping {};       // Whether a channel was clipping in the previous frame.
+    float                    m_fullScale = 1.0f;  // Level (in amp) at which the samples of the file clip.
+
+    void prepare (const juce::AudioFormatReader& reader, OfflineResult& result);
+    void processChunk (const float* const* channelData, int numSamples, OfflineResult& result) noexcept;
+    void addFrame (OfflineResult& result);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineMeter)
+};
+}  // namespace SoundMeter
+}  // namespace sd
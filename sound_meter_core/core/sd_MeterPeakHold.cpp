@@ -0,0 +1,86 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterPeakHold.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+float PeakHold::process (float level_db, double time_ms, float elapsed_ms, float holdTime_ms, float fallRate_dbPerMs) noexcept
+{
+    // Levels below the new one can never be the maximum again...
+    while (m_size > 0 && back().level_db <= level_db)
+        --m_size;
+
+    // Push the new level, or merge it into the newest entry (which is higher) when that entry's span allows...
+    auto merged = false;
+    if (m_size > 0)
+    {
+        auto&      newest = back();
+        const auto span   = newest.span_ms + static_cast<float> (time_ms - newest.time_ms);
+        if (m_size == kCapacity || span < holdTime_ms / kCapacity)
+        {
+            newest.time_ms = time_ms;
+            newest.span_ms = span;
+            merged         = true;
+        }
+    }
+    if (!merged)
+    {
+        ++m_size;
+        back() = { time_ms, level_db, 0.0f };
+    }
+
+    // Remove the levels that left the window (the newest entry always stays)...
+    while (m_size > 1 && front().time_ms + holdTime_ms < time_ms)
+    {
+        m_front = (m_front + 1) % kCapacity;
+        --m_size;
+    }
+
+    const auto windowMax_db = front().level_db;
+    m_level_db              = fallRate_dbPerMs > 0.0f ? std::max (windowMax_db, m_level_db - fallRate_dbPerMs * elapsed_ms) : windowMax_db;
+    return m_level_db;
+}
+//==============================================================================
+
+void PeakHold::reset (float level_db) noexcept
+{
+    m_front    = 0;
+    m_size     = 0;
+    m_level_db = level_db;
+}
+//==============================================================================
+
+}  // namespace SoundMeter
+}  // namespace sd
@@ -0,0 +1,98 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief Sliding window peak hold.
+ *
+ * Holds the maximum level of the last 'hold time' milliseconds, using a monotonic (decreasing) max queue.
+ * Every level is pushed and popped at most once, so the cost is O(1) amortized, without any rescans.
+ * When a level leaves the window, the hold can fall back to the next maximum at a configurable rate.
+ *
+ * The queue is a fixed capacity ring, so it never allocates. To never run out of room, an entry covers a span of
+ * up to 'hold time / capacity' milliseconds: levels arriving within that span are merged into the newest entry.
+ * This extends the lifetime of the (higher) level of that entry by at most that span, but never under-reads the maximum.
+*/
+class PeakHold final
+{
+public:
+    static constexpr int kCapacity = 64;  ///< Maximum number of entries in the queue.
+
+    /**
+     * @brief Add a level and get the held level.
+     *
+     * @param level_db        The new level (in decibels).
+     * @param time_ms         The time of the new level (in milliseconds). Should never decrease.
+     * @param elapsed_ms      The time elapsed since the previous level (in milliseconds). Used for the fall back.
+     * @param holdTime_ms     The length of the window (in milliseconds).
+     * @param fallRate_dbPerMs The rate at which the hold falls back to the next maximum (in decibels per millisecond), or 0 to fall back at once.
+     * @return The held level (in decibels).
+    */
+    float process (float level_db, double time_ms, float elapsed_ms, float holdTime_ms, float fallRate_dbPerMs) noexcept;
+
+    /**
+     * @brief Get the held level.
+     * @return The held level (in decibels).
+    */
+    [[nodiscard]] float getLevel() const noexcept { return m_level_db; }
+
+    /**
+     * @brief Clear the queue and reset the held level.
+     * @param level_db The level to reset to (in decibels).
+    */
+    void reset (float level_db) noexcept;
+
+private:
+    struct Entry
+    {
+        double time_ms  = 0.0;   // Time of the newest level merged into this entry.
+        float  level_db = 0.0f;  // Maximum level of the entry.
+        float  span_ms  = 0.0f;  // Time between the first and the newest level merged into this entry.
+    };
+
+    std::array<Entry, kCapacity> m_entries {};
+    int                          m_front    = 0;
+    int                          m_size     = 0;
+    float                        m_level_db = std::numeric_limits<float>::lowest();
+
+    [[nodiscard]] Entry& back() noexcept { return m_entries[static_cast<size_t> ((m_front + m_size - 1) % kCapacity)]; }
+    [[nodiscard]] Entry& front() noexcept { return m_entries[static_cast<size_t> (m_front)]; }
+};
+}  // namespace SoundMeter
+}  // namespace sd
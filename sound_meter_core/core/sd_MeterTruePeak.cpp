@@ -0,0 +1,143 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterTruePeak.h"
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+namespace
+{
+// ITU-R BS.1770-4 (annex 2) interpolation filter, with the taps reversed (oldest sample first)
+// and the 4 phases interleaved, so each tap can be applied to all phases in one go.
+alignas (16) constexpr float kTruePeakCoefficients[TruePeakDetector::kNumTapsPerPhase][TruePeakDetector::kOversamplingFactor] = {
+    { -0.0083007812500f, -0.0189208984375f, -0.0291748046875f, 0.0017089843750f },
+    { 0.0148925781250f, 0.0330810546875f, 0.0292968750000f, 0.0109863281250f },
+    { -0.0266113281250f, -0.0582275390625f, -0.0517578125000f, -0.0196533203125f },
+    { 0.0476074218750f, 0.1015625000000f, 0.0891113281250f, 0.0332031250000f },
+    { -0.1022949218750f, -0.2003173828125f, -0.1665039062500f, -0.0594482421875f },
+    { 0.9721679687500f, 0.7797851562500f, 0.4650878906250f, 0.1373291015625f },
+    { 0.1373291015625f, 0.4650878906250f, 0.7797851562500f, 0.9721679687500f },
+    { -0.0594482421875f, -0.1665039062500f, -0.2003173828125f, -0.1022949218750f },
+    { 0.0332031250000f, 0.0891113281250f, 0.1015625000000f, 0.0476074218750f },
+    { -0.0196533203125f, -0.0517578125000f, -0.0582275390625f, -0.0266113281250f },
+    { 0.0109863281250f, 0.0292968750000f, 0.0330810546875f, 0.0148925781250f },
+    { 0.0017089843750f, -0.0291748046875f, -0.0189208984375f, -0.0083007812500f }
+};
+
+constexpr int kHistorySize = 2 * TruePeakDetector::kNumTapsPerPhase;
+constexpr int kNumSums     = 4;
+}  // namespace
+//==============================================================================
+
+void TruePeakDetector::prepare (int numChannels)
+{
+    m_numChannels = std::max (0, numChannels);
+    m_history.assign (static_cast<size_t> (m_numChannels * kHistorySize), 0.0f);
+    m_writePosition.assign (static_cast<size_t> (m_numChannels), 0);
+}
+//==============================================================================
+
+void TruePeakDetector::reset() noexcept
+{
+    std::fill (m_history.begin(), m_history.end(), 0.0f);
+    std::fill (m_writePosition.begin(), m_writePosition.end(), 0);
+}
+//==============================================================================
+
+float TruePeakDetector::process (int channel, const float* samples, int numSamples) noexcept
+{
+    if (!juce::isPositiveAndBelow (channel, m_numChannels) || samples == nullptr)
+        return 0.0f;
+
+    auto* history  = m_history.data() + channel * kHistorySize;
+    auto  position = m_writePosition[static_cast<size_t> (channel)];
+
+#if JUCE_USE_SSE_INTRINSICS
+    const auto absMask = _mm_castsi128_ps (_mm_set1_epi32 (0x7fffffff));
+    auto       peak    = _mm_setzero_ps();
+#elif JUCE_USE_ARM_NEON
+    auto peak = vdupq_n_f32 (0.0f);
+#else
+    float peak[kOversamplingFactor] = {};
+#endif
+
+    for (int sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx)
+    {
+        position                               = (position + 1) % kNumTapsPerPhase;
+        history[position]                      = samples[sampleIdx];
+        history[position + kNumTapsPerPhase]   = samples[sampleIdx];
+        const auto* window                     = history + position + 1;  // The last 12 samples, oldest first.
+
+        // Taps are accumulated in interleaved sums, to shorten the dependency chain of the additions.
+#if JUCE_USE_SSE_INTRINSICS
+        __m128 sums[kNumSums];
+        for (int sum = 0; sum < kNumSums; ++sum)
+            sums[sum] = _mm_mul_ps (_mm_load_ps (kTruePeakCoefficients[sum]), _mm_set1_ps (window[sum]));
+        for (int tap = kNumSums; tap < kNumTapsPerPhase; ++tap)
+            sums[tap % kNumSums] = _mm_add_ps (sums[tap % kNumSums], _mm_mul_ps (_mm_load_ps (kTruePeakCoefficients[tap]), _mm_set1_ps (window[tap])));
+        const auto phases = _mm_add_ps (_mm_add_ps (sums[0], sums[1]), _mm_add_ps (sums[2], sums[3]));
+        peak              = _mm_max_ps (peak, _mm_and_ps (phases, absMask));
+#elif JUCE_USE_ARM_NEON
+        float32x4_t sums[kNumSums];
+        for (int sum = 0; sum < kNumSums; ++sum)
+            sums[sum] = vmulq_n_f32 (vld1q_f32 (kTruePeakCoefficients[sum]), window[sum]);
+        for (int tap = kNumSums; tap < kNumTapsPerPhase; ++tap)
+            sums[tap % kNumSums] = vmlaq_n_f32 (sums[tap % kNumSums], vld1q_f32 (kTruePeakCoefficients[tap]), window[tap]);
+        const auto phases = vaddq_f32 (vaddq_f32 (sums[0], sums[1]), vaddq_f32 (sums[2], sums[3]));
+        peak              = vmaxq_f32 (peak, vabsq_f32 (phases));
+#else
+        float phases[kOversamplingFactor] = {};
+        for (int tap = 0; tap < kNumTapsPerPhase; ++tap)
+            for (int phase = 0; phase < kOversamplingFactor; ++phase)
+                phases[phase] += kTruePeakCoefficients[tap][phase] * window[tap];
+        for (int phase = 0; phase < kOversamplingFactor; ++phase)
+            peak[phase] = std::max (peak[phase], std::abs (phases[phase]));
+#endif
+    }
+
+    m_writePosition[static_cast<size_t> (channel)] = position;
+
+    alignas (16) float phasePeaks[kOversamplingFactor];
+#if JUCE_USE_SSE_INTRINSICS
+    _mm_store_ps (phasePeaks, peak);
+#elif JUCE_USE_ARM_NEON
+    vst1q_f32 (phasePeaks, peak);
+#else
+    std::copy (peak, peak + kOversamplingFactor, phasePeaks);
+#endif
+    return std::max (std::max (phasePeaks[0], phasePeaks[1]), std::max (phasePeaks[2], phasePeaks[3]));
+}
+//==============================================================================
+}  // namespace SoundMeter
+}  // namespace sd
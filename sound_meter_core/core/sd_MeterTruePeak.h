@@ -0,0 +1,97 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief True-peak (inter-sample peak) detector.
+ *
+ * Measures the true-peak level as described in ITU-R BS.1770 (annex 2),
+ * by 4x over-sampling the audio with a 48 tap poly-phase interpolation filter.
+ * All 4 phases of an input sample are calculated at once, using SIMD when available.
+ *
+ * The filter state of every channel is kept, so audio can be processed block by block on the audio thread.
+*/
+class TruePeakDetector final
+{
+public:
+    /**
+     * @brief Prepare the detector for a number of channels.
+     *
+     * Beware: this allocates, so never call this while the audio engine is processing!
+     *
+     * @param numChannels The number of channels to prepare the detector for.
+    */
+    void prepare (int numChannels);
+
+    /** @brief Clear the filter state of all channels.*/
+    void reset() noexcept;
+
+    /**
+     * @brief Get the number of channels the detector is prepared for.
+     *
+     * @return The number of channels.
+    */
+    [[nodiscard]] int getNumChannels() const noexcept { return m_numChannels; }
+
+    /**
+     * @brief Process a block of samples of a channel.
+     *
+     * Channels outside the prepared range are ignored.
+     *
+     * @param channel    The channel the samples belong to.
+     * @param samples    The samples to process.
+     * @param numSamples The number of samples to process.
+     * @return The (absolute) true-peak level of the block (in amp).
+    */
+    [[nodiscard]] float process (int channel, const float* samples, int numSamples) noexcept;
+
+    static constexpr int kOversamplingFactor = 4;   ///< Over-sampling factor of the interpolation filter.
+    static constexpr int kNumTapsPerPhase    = 12;  ///< Number of filter taps of each phase.
+
+private:
+    // Per channel history of the input, stored twice so the filter always reads a contiguous window.
+    std::vector<float> m_history {};
+    std::vector<int>   m_writePosition {};
+    int                m_numChannels = 0;
+
+    JUCE_LEAK_DETECTOR (TruePeakDetector)
+};
+}  // namespace SoundMeter
+}  // namespace sd
@@ -0,0 +1,84 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter_core JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+/*******************************************************************************
+ The block below describes the properties of this module, and is read by
+ the Projucer to automatically generate project code that uses it.
+ For details about the syntax and how to create or use a module, see the
+ JUCE Module Format.txt file.
+
+#if 0
+BEGIN_JUCE_MODULE_DECLARATION
+
+    ID:                 sound_meter_core
+    vendor:             Sound Development
+    name:               Headless metering core (levels, ballistics, peak hold, true-peak and loudness).
+    version:            0.9.0
+    description:        The metering engine of sound_meter, without any GUI dependency. Use it on it's own for offline analysis or server-side metering.
+    website:            https://www.sounddevelopment.nl
+    license:            MIT
+    minimumCppStandard: 17
+    dependencies:       juce_core, juce_audio_basics
+END_JUCE_MODULE_DECLARATION
+
+#endif
+
+@defgroup sound_meter_core
+
+ This juce module contains the metering engine of sound_meter:
+ the meter bank (levels, ballistics, peak hold and clip detection),
+ the true-peak detector and the loudness engine.
+
+ When the juce_audio_formats module is part of the project, it also contains
+ the offline (faster than real-time) file meter.
+
+*******************************************************************************/
+
+#pragma once
+
+#define SD_SOUND_METER_CORE_H_INCLUDED
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include "core/sd_MeterConstants.h"
+#include "core/sd_MeterAudioHelpers.h"
+#include "core/sd_MeterDecibels.h"
+#include "core/sd_MeterBallistics.h"
+#include "core/sd_MeterClock.h"
+#include "core/sd_MeterTruePeak.h"
+#include "core/sd_MeterLoudness.h"
+#include "core/sd_MeterPeakHold.h"
+#include "core/sd_MeterBank.h"
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_formats
+ #include "core/sd_MeterOffline.h"
+#endif
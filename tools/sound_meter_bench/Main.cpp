@@ -0,0 +1,120 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include <sound_meter_core/sound_meter_core.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace sd::SoundMeter;
+
+namespace
+{
+constexpr auto kUsage = R"(Usage: sound_meter_bench [options]
+
+Measures the cost of the true-peak detector (and, for comparison, the sample peak),
+processing noise block by block like the audio thread would.
+
+Options:
+  --channels=<n>            Number of channels (default: 32).
+  --sample-rate=<Hz>        Sample rate, to express the cost as real-time load (default: 96000).
+  --block-size=<n>          Number of samples per block (default: 512).
+  --seconds=<s>             Seconds of audio to process (default: 10).
+)";
+
+/** Process all blocks with a function, returning the (best of 3) time per input sample, in nanoseconds. */
+template <typename ProcessBlock>
+double measure (int numChannels, juce::int64 numBlocks, int blockSize, ProcessBlock&& processBlock)
+{
+    auto best_ns = std::numeric_limits<double>::max();
+    for (int run = 0; run < 3; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (juce::int64 blockIdx = 0; blockIdx < numBlocks; ++blockIdx)
+            processBlock();
+        const auto elapsed_ns = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now() - start).count();
+        best_ns               = std::min (best_ns, elapsed_ns / (static_cast<double> (numBlocks) * blockSize * numChannels));
+    }
+    return best_ns;
+}
+}  // namespace
+
+int main (int argc, char* argv[])
+{
+    const juce::ArgumentList args (argc, argv);
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << kUsage;
+        return 0;
+    }
+
+    auto getOption = [&args] (const juce::String& option, double defaultValue)
+    { return args.containsOption (option) ? args.getValueForOption (option).getDoubleValue() : defaultValue; };
+
+    const auto numChannels = std::max (1, static_cast<int> (getOption ("--channels", 32)));
+    const auto sampleRate  = std::max (1.0, getOption ("--sample-rate", 96000.0));
+    const auto blockSize   = std::max (1, static_cast<int> (getOption ("--block-size", 512)));
+    const auto numBlocks   = std::max (juce::int64 { 1 }, static_cast<juce::int64> (getOption ("--seconds", 10.0) * sampleRate / blockSize));
+
+    // Noise (with the odd over), so no branch or denormal makes it look cheaper than real audio...
+    juce::AudioBuffer<float> buffer (numChannels, blockSize);
+    juce::Random             random (1);
+    for (int channelIdx = 0; channelIdx < numChannels; ++channelIdx)
+        for (int sampleIdx = 0; sampleIdx < blockSize; ++sampleIdx)
+            buffer.setSample (channelIdx, sampleIdx, random.nextFloat() * 2.2f - 1.1f);
+
+    TruePeakDetector truePeakDetector;
+    truePeakDetector.prepare (numChannels);
+
+    volatile float peak = 0.0f;  // Keeps the compiler from optimising the work away.
+
+    const auto truePeak_ns = measure (numChannels, numBlocks, blockSize,
+                                      [&]
+                                      {
+                                          for (int channelIdx = 0; channelIdx < numChannels; ++channelIdx)
+                                              peak = truePeakDetector.process (channelIdx, buffer.getReadPointer (channelIdx), blockSize);
+                                      });
+    const auto samplePeak_ns = measure (numChannels, numBlocks, blockSize,
+                                        [&]
+                                        {
+                                            for (int channelIdx = 0; channelIdx < numChannels; ++channelIdx)
+                                                peak = Helpers::getPeakLevel (buffer.getReadPointer (channelIdx), blockSize);
+                                        });
+
+    // The share of one core needed to keep up with real-time...
+    auto getLoad = [&] (double cost_ns) { return cost_ns * numChannels * sampleRate * 1.0e-9 * 100.0; };
+
+    std::cout << numChannels << " channels, " << sampleRate << " Hz, blocks of " << blockSize << " samples\n";
+    std::cout << "true-peak:   " << truePeak_ns << " ns per sample (" << getLoad (truePeak_ns) << " % of a core)\n";
+    std::cout << "sample peak: " << samplePeak_ns << " ns per sample (" << getLoad (samplePeak_ns) << " % of a core)\n";
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterScanner.h"
+
+#include <iostream>
+#include <map>
+
+using namespace sd::SoundMeter;
+
+namespace
+{
+constexpr auto kUsage = R"(Usage: sound_meter_scan [options] <file or directory>...
+
+Meters audio files (directories are searched recursively) and reports, per file,
+the max sample peak, max true-peak, clip count and integrated loudness.
+
+Options:
+  --format=csv|json         Report format (default: csv).
+  --output=<file>           Write the report to a file (default: standard output).
+  --threads=<n>             Number of worker threads (default: all cores).
+  --scale=default|smpte|yamaha60
+                            Meter scale, defining the level range (default: default).
+  --ballistics=linear|exponential|vu|ppm1|ppm2|nordic|none
+                            Meter ballistics (default: linear).
+  --decay=<ms>              Meter decay (default: 1000 ms).
+  --peak-hold=<ms>          Peak hold window (default: 2000 ms).
+  --peak-fall=<dB/s>        Peak hold fall back rate (default: 0, falls back at once).
+  --refresh-rate=<Hz>       Meter refresh rate (default: 30 Hz).
+  --true-peak               Meter true-peak levels instead of sample peaks.
+  --sample-accurate         Use sample accurate ballistics.
+
+Exits with 2 when one or more files could not be scanned.
+)";
+
+bool parseBallistics (const juce::String& name, BallisticsType& ballistics)
+{
+    static const std::map<juce::String, BallisticsType> kBallistics { { "linear", BallisticsType::linear },
+                                                                      { "exponential", BallisticsType::exponential },
+                                                                      { "vu", BallisticsType::vu },
+                                                                      { "ppm1", BallisticsType::ppmType1 },
+                                                                      { "ppm2", BallisticsType::ppmType2 },
+                                                                      { "nordic", BallisticsType::ppmNordic },
+                                                                      { "none", BallisticsType::none } };
+    const auto it = kBallistics.find (name.toLowerCase());
+    if (it == kBallistics.end())
+        return false;
+
+    ballistics = it->second;
+    return true;
+}
+
+bool parseScale (const juce::String& name, juce::Range<float>& levelRange)
+{
+    // The level ranges of the meter scales (see MeterScales in the sound_meter module)...
+    if (name.equalsIgnoreCase ("default"))
+        levelRange = { Constants::kDefaultScaleMin_db, Constants::kMaxLevel_db };
+    else if (name.equalsIgnoreCase ("smpte"))
+        levelRange = { Constants::kSmpteScaleMin_db, Constants::kMaxLevel_db };
+    else if (name.equalsIgnoreCase ("yamaha60"))
+        levelRange = { Constants::kYamaha60ScaleMin_db, Constants::kMaxLevel_db };
+    else
+        return false;
+
+    return true;
+}
+}  // namespace
+
+int main (int argc, char* argv[])
+{
+    const juce::ArgumentList args (argc, argv);
+
+    juce::StringArray paths;
+    for (const auto& arg: args.arguments)
+        if (!arg.isOption())
+            paths.add (arg.text);
+
+    if (paths.isEmpty() || args.containsOption ("--help|-h"))
+    {
+        std::cout << kUsage;
+        return args.containsOption ("--help|-h") ? 0 : 1;
+    }
+
+    // The same options as the meters on screen...
+    OfflineOptions offlineOptions;
+    offlineOptions.levelRange = { Constants::kDefaultScaleMin_db, Constants::kMaxLevel_db };
+
+    if (args.containsOption ("--scale") && !parseScale (args.getValueForOption ("--scale"), offlineOptions.levelRange))
+    {
+        std::cerr << "Unknown scale: " << args.getValueForOption ("--scale") << "\n";
+        return 1;
+    }
+    if (args.containsOption ("--ballistics") && !parseBallistics (args.getValueForOption ("--ballistics"), offlineOptions.ballistics))
+    {
+        std::cerr << "Unknown ballistics: " << args.getValueForOption ("--ballistics") << "\n";
+        return 1;
+    }
+    if (args.containsOption ("--decay"))
+        offlineOptions.decayTime_ms = args.getValueForOption ("--decay").getFloatValue();
+    if (args.containsOption ("--peak-hold"))
+        offlineOptions.peakDecayTime_ms = args.getValueForOption ("--peak-hold").getFloatValue();
+    if (args.containsOption ("--peak-fall"))
+        offlineOptions.peakFallRate = args.getValueForOption ("--peak-fall").getFloatValue();
+    if (args.containsOption ("--refresh-rate"))
+        offlineOptions.frameRate = args.getValueForOption ("--refresh-rate").getDoubleValue();
+    offlineOptions.truePeakEnabled          = args.containsOption ("--true-peak");
+    offlineOptions.sampleAccurateBallistics = args.containsOption ("--sample-accurate");
+
+    const auto format = args.containsOption ("--format") ? args.getValueForOption ("--format").toLowerCase() : juce::String ("csv");
+    if (format != "csv" && format != "json")
+    {
+        std::cerr << "Unknown format: " << format << "\n";
+        return 1;
+    }
+
+    const Scanner scanner (offlineOptions, args.getValueForOption ("--threads").getIntValue());
+    const auto    reports = scanner.scan (Scanner::findFiles (paths));
+
+    juce::MemoryOutputStream report;
+    if (format == "json")
+        Scanner::writeJson (reports, report);
+    else
+        Scanner::writeCsv (reports, report);
+
+    if (args.containsOption ("--output"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--output"));
+        if (!file.replaceWithData (report.getData(), report.getDataSize()))
+        {
+            std::cerr << "Could not write to: " << file.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << report.toString();
+    }
+
+    const auto numFailed = std::count_if (reports.begin(), reports.end(), [] (const FileReport& fileReport) { return fileReport.error.isNotEmpty(); });
+    return numFailed > 0 ? 2 : 0;
+}
@@ -0,0 +1,276 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#include "sd_MeterScanner.h"
+
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+namespace
+{
+// The files of a worker. The owner takes from the front, thieves take from the back.
+// A file takes far longer to meter than the lock takes, so a plain mutex is all that's needed.
+class TaskQueue
+{
+public:
+    void push (int task)
+    {
+        const std::scoped_lock lock (m_mutex);
+        m_tasks.push_back (task);
+    }
+
+    [[nodiscard]] int pop()
+    {
+        const std::scoped_lock lock (m_mutex);
+        if (m_tasks.empty())
+            return -1;
+
+        const auto task = m_tasks.front();
+        m_tasks.pop_front();
+        return task;
+    }
+
+    [[nodiscard]] int steal()
+    {
+        const std::scoped_lock lock (m_mutex);
+        if (m_tasks.empty())
+            return -1;
+
+        const auto task = m_tasks.back();
+        m_tasks.pop_back();
+        return task;
+    }
+
+private:
+    std::mutex      m_mutex;
+    std::deque<int> m_tasks;
+};
+
+juce::String toCsvField (const juce::String& field)
+{
+    return "\"" + field.replace ("\"", "\"\"") + "\"";
+}
+}  // namespace
+//==============================================================================
+
+Scanner::Scanner (const OfflineOptions& options, int numThreads /*= 0*/)
+  : m_options (options), m_numThreads (numThreads > 0 ? numThreads : juce::SystemStats::getNumCpus())
+{
+    m_options.loudnessEnabled = true;  // The integrated loudness is part of the report.
+}
+//==============================================================================
+
+juce::Array<juce::File> Scanner::findFiles (const juce::StringArray& paths)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    const auto wildcard = formatManager.getWildcardForAllFormats();
+
+    juce::Array<juce::File> files;
+    for (const auto& path: paths)
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (path);
+        if (file.isDirectory())
+        {
+            for (const auto& entry: juce::RangedDirectoryIterator (file, true, wildcard, juce::File::findFiles))
+                files.addIfNotAlreadyThere (entry.getFile());
+        }
+        else if (file.existsAsFile())
+        {
+            files.addIfNotAlreadyThere (file);
+        }
+    }
+
+    files.sort();
+    return files;
+}
+//==============================================================================
+
+std::vector<FileReport> Scanner::scan (const juce::Array<juce::File>& files) const
+{
+    std::vector<FileReport> reports (static_cast<size_t> (files.size()));
+    if (files.isEmpty())
+        return reports;
+
+    const auto             numWorkers = std::min (m_numThreads, files.size());
+    std::vector<TaskQueue> queues (static_cast<size_t> (numWorkers));
+
+    // Deal out the files largest first, so the long files start early and the short ones fill up the gaps...
+    std::vector<int> order (static_cast<size_t> (files.size()));
+    std::iota (order.begin(), order.end(), 0);
+    std::stable_sort (order.begin(), order.end(), [&files] (int a, int b) { return files.getReference (a).getSize() > files.getReference (b).getSize(); });
+    for (size_t idx = 0; idx < order.size(); ++idx)
+        queues[idx % static_cast<size_t> (numWorkers)].push (order[idx]);
+
+    auto work = [&] (int worker)
+    {
+        OfflineMeter             offlineMeter (m_options);
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        for (;;)
+        {
+            auto fileIdx = queues[static_cast<size_t> (worker)].pop();
+            for (int victim = 1; victim < numWorkers && fileIdx < 0; ++victim)
+                fileIdx = queues[static_cast<size_t> ((worker + victim) % numWorkers)].steal();
+
+            if (fileIdx < 0)
+                return;  // Files are never added once scanning, so all queues are empty.
+
+            reports[static_cast<size_t> (fileIdx)] = scanFile (files.getReference (fileIdx), offlineMeter, formatManager);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < numWorkers; ++worker)
+        threads.emplace_back (work, worker);
+    work (0);
+    for (auto& thread: threads)
+        thread.join();
+
+    return reports;
+}
+//==============================================================================
+
+FileReport Scanner::scanFile (const juce::File& file, OfflineMeter& offlineMeter, juce::AudioFormatManager& formatManager)
+{
+    FileReport report;
+    report.file = file;
+
+    const auto reader = createReader (file, formatManager);
+    if (reader == nullptr)
+    {
+        report.error = "Unsupported or unreadable file";
+        return report;
+    }
+    if (reader->sampleRate <= 0.0 || reader->numChannels == 0)
+    {
+        report.error = "No audio";
+        return report;
+    }
+
+    const auto result = offlineMeter.process (*reader);
+
+    report.sampleRate         = reader->sampleRate;
+    report.numChannels        = static_cast<int> (reader->numChannels);
+    report.duration_s         = static_cast<double> (result.numSamplesMetered) / reader->sampleRate;
+    report.maxSamplePeak_db   = Decibels::gainToDecibels (*std::max_element (result.maxSamplePeaks.begin(), result.maxSamplePeaks.end()), Decibels::kMinusInfinity_db);
+    report.maxTruePeak_db     = Decibels::gainToDecibels (*std::max_element (result.maxTruePeaks.begin(), result.maxTruePeaks.end()), Decibels::kMinusInfinity_db);
+    report.numClips           = static_cast<int> (result.clipEvents.size());
+    report.numClippedSamples  = std::accumulate (result.numClippedSamples.begin(), result.numClippedSamples.end(), juce::int64 { 0 });
+    report.integratedLoudness = result.integratedLoudness;
+
+    // A file that could only be read partly must not pass QC...
+    if (result.readFailed)
+        report.error = "Read failed after " + juce::String (report.duration_s, 3) + " s of " + juce::String (static_cast<double> (result.numSamplesRequested) / reader->sampleRate, 3) + " s";
+
+    return report;
+}
+//==============================================================================
+
+std::unique_ptr<juce::AudioFormatReader> Scanner::createReader (const juce::File& file, juce::AudioFormatManager& formatManager)
+{
+    // Memory map the file when the format supports it (WAV, AIFF), so reading is just copying from the page cache...
+    if (auto* format = formatManager.findFormatForFileExtension (file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader (format->createMemoryMappedReader (file));
+        if (mappedReader != nullptr && mappedReader->mapEntireFile())
+            return mappedReader;
+    }
+
+    // ... otherwise stream it (the offline meter reads large blocks).
+    return std::unique_ptr<juce::AudioFormatReader> (formatManager.createReaderFor (file));
+}
+//==============================================================================
+
+void Scanner::writeCsv (const std::vector<FileReport>& reports, juce::OutputStream& output)
+{
+    output << "file,sample_rate,channels,duration_s,max_sample_peak_dbfs,max_true_peak_dbtp,clips,clipped_samples,integrated_lufs,error\n";
+
+    for (const auto& report: reports)
+    {
+        juce::StringArray fields;
+        fields.add (toCsvField (report.file.getFullPathName()));
+        fields.add (juce::String (report.sampleRate, 0));
+        fields.add (juce::String (report.numChannels));
+        fields.add (juce::String (report.duration_s, 3));
+        fields.add (juce::String (report.maxSamplePeak_db, 2));
+        fields.add (juce::String (report.maxTruePeak_db, 2));
+        fields.add (juce::String (report.numClips));
+        fields.add (juce::String (report.numClippedSamples));
+        fields.add (juce::String (report.integratedLoudness, 1));
+        fields.add (toCsvField (report.error));
+        output << fields.joinIntoString (",") << "\n";
+    }
+}
+//==============================================================================
+
+void Scanner::writeJson (const std::vector<FileReport>& reports, juce::OutputStream& output)
+{
+    auto round = [] (double value, double resolution) { return std::round (value / resolution) * resolution; };
+
+    juce::Array<juce::var> fileReports;
+    for (const auto& report: reports)
+    {
+        auto* fileReport = new juce::DynamicObject();
+        fileReport->setProperty ("file", report.file.getFullPathName());
+        if (report.error.isNotEmpty())
+        {
+            fileReport->setProperty ("error", report.error);
+        }
+        else
+        {
+            fileReport->setProperty ("sampleRate", report.sampleRate);
+            fileReport->setProperty ("channels", report.numChannels);
+            fileReport->setProperty ("duration_s", round (report.duration_s, 0.001));
+            fileReport->setProperty ("maxSamplePeak_dbfs", round (report.maxSamplePeak_db, 0.01));
+            fileReport->setProperty ("maxTruePeak_dbtp", round (report.maxTruePeak_db, 0.01));
+            fileReport->setProperty ("clips", report.numClips);
+            fileReport->setProperty ("clippedSamples", report.numClippedSamples);
+            fileReport->setProperty ("integrated_lufs", round (report.integratedLoudness, 0.1));
+        }
+        fileReports.add (juce::var (fileReport));
+    }
+
+    juce::JSON::writeToStream (output, juce::var (fileReports));
+    output << "\n";
+}
+//==============================================================================
+
+}  // namespace SoundMeter
+}  // namespace sd
@@ -0,0 +1,129 @@
+/*
+    ==============================================================================
+    
+    This file is part of the sound_meter JUCE module
+    Copyright (c) 2019 - 2021 Sound Development - Marcel Huibers
+    All rights reserved.
+
+    ------------------------------------------------------------------------------
+
+    sound_meter is provided under the terms of The MIT License (MIT):
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+    ==============================================================================
+*/
+
+#pragma once
+
+#include <sound_meter_core/sound_meter_core.h>
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+
+namespace sd  // NOLINT
+{
+namespace SoundMeter
+{
+/**
+ * @brief The QC report of a single file.
+*/
+struct FileReport
+{
+    juce::File   file {};                  ///< The file scanned.
+    juce::String error {};                 ///< Why the file could not be scanned (empty when it was scanned).
+    double       sampleRate         = 0.0;  ///< Sample rate (in Hz).
+    int          numChannels        = 0;    ///< Number of channels.
+    double       duration_s         = 0.0;  ///< Duration metered (in seconds). Shorter than the file when reading failed.
+    float        maxSamplePeak_db   = Decibels::kMinusInfinity_db;  ///< Maximum sample peak of all channels (in dBFS).
+    float        maxTruePeak_db     = Decibels::kMinusInfinity_db;  ///< Maximum true-peak of all channels (in dBTP).
+    int          numClips           = 0;    ///< Number of times the clip indicator of a channel lit up.
+    juce::int64  numClippedSamples  = 0;    ///< Number of samples at (or over) full scale, of all channels.
+    float        integratedLoudness = Constants::kMinLevel_db;  ///< Integrated loudness (in LUFS).
+};
+
+/**
+ * @brief Scans audio files in parallel, metering them with the offline meter.
+ *
+ * Every worker thread has it's own offline meter and format manager, so nothing is shared while metering.
+ * The files are dealt out to the workers (largest first) and a worker that runs out of files steals from the others.
+*/
+class Scanner final
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param options    The offline meter options.
+     * @param numThreads The number of worker threads, or 0 to use all cores.
+    */
+    explicit Scanner (const OfflineOptions& options, int numThreads = 0);
+
+    /**
+     * @brief Find all audio files.
+     *
+     * @param paths The files and directories (searched recursively) to find audio files in.
+     * @return The audio files found.
+    */
+    [[nodiscard]] static juce::Array<juce::File> findFiles (const juce::StringArray& paths);
+
+    /**
+     * @brief Scan files.
+     *
+     * @param files The files to scan.
+     * @return The report of every file, in the same order as the files.
+    */
+    [[nodiscard]] std::vector<FileReport> scan (const juce::Array<juce::File>& files) const;
+
+    /**
+     * @brief Scan a single file.
+     *
+     * @param file          The file to scan.
+     * @param offlineMeter  The offline meter to use.
+     * @param formatManager The format manager to create the reader with.
+     * @return The report of the file.
+    */
+    [[nodiscard]] static FileReport scanFile (const juce::File& file, OfflineMeter& offlineMeter, juce::AudioFormatManager& formatManager);
+
+    /**
+     * @brief Write reports as CSV (one line per file).
+     *
+     * @param reports The reports to write.
+     * @param output  The stream to write to.
+    */
+    static void writeCsv (const std::vector<FileReport>& reports, juce::OutputStream& output);
+
+    /**
+     * @brief Write reports as JSON (an array with an object per file).
+     *
+     * @param reports The reports to write.
+     * @param output  The stream to write to.
+    */
+    static void writeJson (const std::vector<FileReport>& reports, juce::OutputStream& output);
+
+private:
+    OfflineOptions m_options {};
+    int            m_numThreads = 1;
+
+    [[nodiscard]] static std::unique_ptr<juce::AudioFormatReader> createReader (const juce::File& file, juce::AudioFormatManager& formatManager);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Scanner)
+};
+}  // namespace SoundMeter
+}  // namespace sd